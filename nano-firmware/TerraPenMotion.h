@@ -17,6 +17,7 @@
 // Hardware drivers
 #include "src/hardware/StepperDriver.h"
 #include "src/hardware/ServoDriver.h"
+#include "src/hardware/StepEngine.h"
 
 // System components
 #include "src/ErrorSystem.h"
@@ -83,19 +83,29 @@
 // Core data structures
 #include "src/TerraPenConfig.h"
 #include "src/Position.h"
+#include "src/BinaryAngle.h"
+#include "src/FastMath.h"
 
 // Hardware drivers
 #include "src/hardware/StepperDriver.h"
 #include "src/hardware/ServoDriver.h"
+#include "src/hardware/StepEngine.h"
 
 // Robot control (Phase 2 complete)
 #include "src/robot/TerraPenRobot.h"
+#include "src/robot/MotionQueue.h"
+#include "src/robot/KinematicModel.h"
 
 // System components (optional - for advanced usage)
 #include "src/ErrorSystem.h"
 #include "src/PerformanceMonitor.h"
+#include "src/TaskScheduler.h"
+#include "src/PowerManager.h"
 #include "src/storage/NVRAMManager.h"
 #include "src/communication/ESP32Uploader.h"
+#include "src/communication/BinaryProtocol.h"
+#include "src/communication/CommandReader.h"
+#include "src/communication/JsonArena.h"
 #include "src/testing/TestFramework.h"
 #include "src/testing/PowerOnSelfTest.h"
 
@@ -2,7 +2,10 @@
  * AdvancedPatternTest.ino
  * 
  * Advanced coordinate system testing with complex patterns.
- * Tests accuracy with multi-segment paths and curve approximation.
+ * Tests accuracy with multi-segment paths and native arcs.
+ * 
+ * Segments are queued on the robot; waitForQueueSlot() keeps the
+ * queue fed without dropping commands when it fills up.
  */
 
 #include <TerraPenMotionControl.h>
@@ -35,6 +38,13 @@ void loop() {
     }
 }
 
+void waitForQueueSlot() {
+    // Keep the robot running while the motion queue is full
+    while (robot.getFreeSlots() == 0) {
+        robot.update();
+    }
+}
+
 void drawComplexPattern() {
     Serial.println("Drawing complex multi-segment pattern...");
     
@@ -44,43 +54,39 @@ void drawComplexPattern() {
     robot.penDown();
     
     // Draw 5-pointed star
+    waitForQueueSlot();
     robot.drawTo(15, 5);      // Right point
+    waitForQueueSlot();
     robot.drawTo(-15, 12);    // Left upper
+    waitForQueueSlot();
     robot.drawTo(15, 12);     // Right upper  
+    waitForQueueSlot();
     robot.drawTo(-15, 5);     // Left point
+    waitForQueueSlot();
     robot.drawTo(0, 20);      // Back to start
     
+    waitForQueueSlot();
     robot.penUp();
     
-    Serial.println("Star pattern complete");
+    Serial.println("Star pattern queued");
     
-    // Circle approximation - tests coordinated movement
-    delay(2000);
-    drawCircleApproximation();
+    // Native circle - tests constant-curvature arcs
+    drawCircle();
 }
 
-void drawCircleApproximation() {
-    Serial.println("Drawing circle approximation...");
+void drawCircle() {
+    Serial.println("Drawing circle...");
     
     float radius = 15.0;
-    int segments = 12;  // 12-sided polygon
     
+    waitForQueueSlot();
     robot.moveTo(radius, 0);  // Move to start point
-    robot.penDown();
     
-    for (int i = 1; i <= segments; i++) {
-        float angle = (2 * PI * i) / segments;
-        float x = radius * cos(angle);
-        float y = radius * sin(angle);
-        robot.drawTo(x, y);
-        
-        // Print progress
-        Serial.print("Segment ");
-        Serial.print(i);
-        Serial.print("/");
-        Serial.println(segments);
-    }
+    // Ending on the start point draws the full circle in one movement
+    waitForQueueSlot();
+    robot.arcTo(0, 0, radius, 0, false);
     
+    waitForQueueSlot();
     robot.penUp();
-    Serial.println("Circle complete");
-}
\ No newline at end of file
+    Serial.println("Circle queued");
+}
@@ -0,0 +1,110 @@
+/**
+ * TerraPen Motion Control Library - Fast Math Benchmark
+ * 
+ * Compares the table-based fastSin/fastCos/fastAtan2 against avr-libc
+ * sin/cos/atan2:
+ * - Cycles per call, timed with micros() over many calls
+ * - Worst-case error over a dense sweep of inputs
+ * 
+ * Use the numbers to decide whether to build with TERRAPEN_FAST_MATH.
+ * 
+ * Usage: Upload to Arduino Nano, open Serial Monitor at 9600 baud to see results
+ */
+
+#include <Arduino.h>
+#include <FastMath.h>
+
+#define BENCH_CALLS 1000
+
+volatile float sink;          // Keeps the compiler from dropping the calls
+volatile float inputs[8];     // Read per call so nothing is constant-folded
+
+/**
+ * Cycles per call of an expression, minus the loop overhead
+ */
+#define BENCH(label, expr, overhead) do { \
+    unsigned long start = micros(); \
+    for (int i = 0; i < BENCH_CALLS; i++) { \
+        float a = inputs[i & 7]; \
+        float b = inputs[(i + 3) & 7]; \
+        sink = (expr); \
+    } \
+    unsigned long elapsed = micros() - start; \
+    float cycles = (float)elapsed * (F_CPU / 1000000L) / BENCH_CALLS - (overhead); \
+    Serial.print(label); \
+    Serial.print(": "); \
+    Serial.print(cycles, 0); \
+    Serial.println(" cycles/call"); \
+} while (0)
+
+void printError(const char* label, float max_error) {
+    Serial.print(label);
+    Serial.print(" max error: ");
+    Serial.println(max_error, 7);
+}
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial) { delay(100); }
+    
+    Serial.println("=== TerraPen Motion Control - Fast Math Benchmark ===");
+    Serial.println();
+    
+    for (int i = 0; i < 8; i++) {
+        inputs[i] = -3.0 + i * 0.83;
+    }
+    
+    // === TIMING ===
+    Serial.println("--- Cycles per call ---");
+    
+    // Loop and volatile access cost, subtracted from every result
+    unsigned long start = micros();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        float a = inputs[i & 7];
+        float b = inputs[(i + 3) & 7];
+        sink = a + b;
+    }
+    float overhead = (float)(micros() - start) * (F_CPU / 1000000L) / BENCH_CALLS;
+    
+    BENCH("libm sin    ", sin(a) + b * 0, overhead);
+    BENCH("fastSin     ", fastSin(a) + b * 0, overhead);
+    BENCH("libm cos    ", cos(a) + b * 0, overhead);
+    BENCH("fastCos     ", fastCos(a) + b * 0, overhead);
+    BENCH("libm atan2  ", atan2(a, b), overhead);
+    BENCH("fastAtan2   ", fastAtan2(a, b), overhead);
+    BENCH("libm sqrt   ", sqrt(a * a + b), overhead);
+    
+    // === ACCURACY ===
+    Serial.println("\n--- Accuracy against libm ---");
+    
+    float sin_error = 0.0;
+    float cos_error = 0.0;
+    for (float angle = -2 * PI; angle <= 2 * PI; angle += 0.0007) {
+        sin_error = max(sin_error, (float)fabs(fastSin(angle) - sin(angle)));
+        cos_error = max(cos_error, (float)fabs(fastCos(angle) - cos(angle)));
+    }
+    printError("fastSin ", sin_error);
+    printError("fastCos ", cos_error);
+    
+    float atan_error = 0.0;
+    for (float y = -50.0; y <= 50.0; y += 0.73) {
+        for (float x = -50.0; x <= 50.0; x += 1.31) {
+            atan_error = max(atan_error, (float)fabs(fastAtan2(y, x) - atan2(y, x)));
+        }
+    }
+    printError("fastAtan2", atan_error);
+    
+    // One wheel step is ~0.038 mm; the worst heading error over a 100 mm
+    // lever arm should stay well below it
+    float lever_error_mm = max(max(sin_error, cos_error), atan_error) * 100.0;
+    Serial.print("\nWorst error over 100 mm: ");
+    Serial.print(lever_error_mm, 4);
+    Serial.println(" mm");
+    Serial.println(lever_error_mm < 0.038 / 10 ? "Within a tenth of a wheel step" :
+                                                  "Exceeds a tenth of a wheel step");
+}
+
+void loop() {
+    // Benchmark runs once in setup()
+    delay(10000);
+}
@@ -0,0 +1,68 @@
+#ifndef BINARY_ANGLE_H
+#define BINARY_ANGLE_H
+
+#include <Arduino.h>
+
+/**
+ * Binary angle (BAM) headings
+ *
+ * A heading is a uint32_t where 2^32 is one full turn. Unsigned overflow
+ * is the wraparound, so sums and differences never need normalising, and
+ * reading a difference as signed gives the shortest turn in [-PI, PI).
+ * Resolution is 1.5e-9 rad and the arithmetic is exact and deterministic.
+ *
+ * Radians (float) are for the API and telemetry boundary only.
+ *
+ * Usage:
+ *   bam_t heading = radiansToBam(PI / 2);
+ *   heading += BAM_HALF_TURN;                       // Wraps to -PI/2
+ *   float turn = bamToRadians(target - heading);    // Shortest turn
+ */
+typedef uint32_t bam_t;
+
+#define BAM_QUARTER_TURN ((bam_t)0x40000000UL)
+#define BAM_HALF_TURN ((bam_t)0x80000000UL)
+#define BAM_PER_RADIAN 683565275.57643158f       // 2^31 / PI
+#define RADIANS_PER_BAM 1.4629180792671596e-9f   // PI / 2^31
+
+/**
+ * Convert radians (any finite value) to a binary angle
+ */
+inline bam_t radiansToBam(float radians) {
+    float scaled = radians * BAM_PER_RADIAN;
+    if (scaled >= -2147483648.0f && scaled < 2147483648.0f) {
+        return (bam_t)(int32_t)scaled;
+    }
+    // Beyond half a turn: go through 64 bits so whole turns wrap away
+    return (bam_t)(int64_t)scaled;
+}
+
+/**
+ * Convert a binary angle to radians in [-PI, PI)
+ */
+inline float bamToRadians(bam_t angle) {
+    return (int32_t)angle * RADIANS_PER_BAM;
+}
+
+/**
+ * Convert a binary angle to radians in [0, 2*PI)
+ */
+inline float bamToPositiveRadians(bam_t angle) {
+    return angle * RADIANS_PER_BAM;
+}
+
+/**
+ * Size of the shortest turn, in binary angle units (0 to BAM_HALF_TURN)
+ */
+inline uint32_t bamMagnitude(bam_t angle) {
+    return ((int32_t)angle < 0) ? (0 - angle) : angle;
+}
+
+/**
+ * Wrap radians into [-PI, PI) without loops
+ */
+inline float wrapRadians(float radians) {
+    return bamToRadians(radiansToBam(radians));
+}
+
+#endif // BINARY_ANGLE_H
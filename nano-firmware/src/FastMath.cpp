@@ -0,0 +1,103 @@
+/**
+ * FastMath Implementation - interpolated PROGMEM tables
+ */
+
+#include "FastMath.h"
+
+// sin(i * (PI/2) / 128) * 65535, i = 0..128
+static const uint16_t SIN_TABLE[FAST_SIN_QUARTER_STEPS + 1] PROGMEM = {
+    0, 804, 1608, 2412, 3216, 4019, 4821, 5623, 6424, 7223,
+    8022, 8820, 9616, 10411, 11204, 11996, 12785, 13573, 14359, 15142,
+    15924, 16703, 17479, 18253, 19024, 19792, 20557, 21319, 22078, 22834,
+    23586, 24334, 25079, 25820, 26557, 27291, 28020, 28745, 29465, 30181,
+    30893, 31600, 32302, 32999, 33692, 34379, 35061, 35738, 36409, 37075,
+    37736, 38390, 39039, 39682, 40319, 40950, 41575, 42194, 42806, 43411,
+    44011, 44603, 45189, 45768, 46340, 46905, 47464, 48014, 48558, 49095,
+    49624, 50145, 50659, 51166, 51664, 52155, 52638, 53113, 53580, 54039,
+    54490, 54933, 55367, 55794, 56211, 56620, 57021, 57413, 57797, 58171,
+    58537, 58895, 59243, 59582, 59913, 60234, 60546, 60850, 61144, 61429,
+    61704, 61970, 62227, 62475, 62713, 62942, 63161, 63371, 63571, 63762,
+    63943, 64114, 64276, 64428, 64570, 64703, 64826, 64939, 65042, 65136,
+    65219, 65293, 65357, 65412, 65456, 65491, 65515, 65530, 65535
+};
+
+// atan(i / 64) / (PI/4) * 65535, i = 0..64
+static const uint16_t ATAN_TABLE[FAST_ATAN_STEPS + 1] PROGMEM = {
+    0, 1304, 2607, 3908, 5208, 6506, 7800, 9090, 10376, 11658,
+    12933, 14203, 15466, 16722, 17970, 19210, 20441, 21664, 22877, 24080,
+    25273, 26456, 27627, 28788, 29936, 31074, 32199, 33312, 34412, 35500,
+    36576, 37638, 38688, 39724, 40747, 41758, 42755, 43738, 44709, 45666,
+    46611, 47541, 48459, 49364, 50256, 51135, 52001, 52854, 53695, 54523,
+    55339, 56142, 56934, 57713, 58481, 59236, 59980, 60713, 61435, 62145,
+    62844, 63533, 64211, 64878, 65535
+};
+
+/**
+ * Interpolate between two table entries with a 16-bit fraction
+ */
+static uint16_t interpolate(const uint16_t* table, uint8_t index, uint16_t fraction) {
+    int32_t a = pgm_read_word(&table[index]);
+    int32_t b = pgm_read_word(&table[index + 1]);
+    return (uint16_t)(a + (((b - a) * (int32_t)fraction + 0x8000) >> 16));
+}
+
+float fastSinBam(bam_t angle) {
+    // Top 9 bits pick the table step (4 quarters of 128), the next 16 the fraction
+    uint16_t step = (uint16_t)(angle >> 23);
+    uint16_t fraction = (uint16_t)(angle >> 7);
+    uint8_t quadrant = step / FAST_SIN_QUARTER_STEPS;
+    uint8_t index = step % FAST_SIN_QUARTER_STEPS;
+    
+    // Second and fourth quadrants run the quarter wave backwards
+    uint16_t value;
+    if (quadrant & 1) {
+        if (fraction == 0) {
+            value = pgm_read_word(&SIN_TABLE[FAST_SIN_QUARTER_STEPS - index]);
+        } else {
+            value = interpolate(SIN_TABLE, FAST_SIN_QUARTER_STEPS - 1 - index, (uint16_t)(0 - fraction));
+        }
+    } else {
+        value = interpolate(SIN_TABLE, index, fraction);
+    }
+    
+    float result = value * (1.0f / 65535.0f);
+    return (quadrant & 2) ? -result : result;
+}
+
+float fastCosBam(bam_t angle) {
+    return fastSinBam(angle + BAM_QUARTER_TURN);
+}
+
+float fastSin(float angle) {
+    return fastSinBam(radiansToBam(angle));
+}
+
+float fastCos(float angle) {
+    return fastSinBam(radiansToBam(angle) + BAM_QUARTER_TURN);
+}
+
+float fastAtan2(float y, float x) {
+    float abs_x = fabs(x);
+    float abs_y = fabs(y);
+    if (abs_x == 0.0f && abs_y == 0.0f) {
+        return 0.0f;
+    }
+    
+    // Reduce to the first octant: ratio in [0, 1]
+    bool steep = abs_y > abs_x;
+    float ratio = steep ? abs_x / abs_y : abs_y / abs_x;
+    
+    uint32_t position = (uint32_t)(ratio * (FAST_ATAN_STEPS * 65536.0f));
+    uint8_t index = position >> 16;
+    float angle;
+    if (index >= FAST_ATAN_STEPS) {
+        angle = PI / 4.0f;
+    } else {
+        angle = interpolate(ATAN_TABLE, index, (uint16_t)position) * (PI / 4.0f / 65535.0f);
+    }
+    
+    // Unfold the octant
+    if (steep) angle = PI / 2.0f - angle;
+    if (x < 0) angle = PI - angle;
+    return (y < 0) ? -angle : angle;
+}
@@ -0,0 +1,78 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "BinaryAngle.h"
+
+/**
+ * FastMath - Table-based sin/cos/atan2 for the FPU-less ATmega328
+ *
+ * avr-libc evaluates sin, cos and atan2 as float polynomials, several
+ * thousand cycles per call. These functions linearly interpolate small
+ * PROGMEM tables in integer arithmetic instead, with a couple of float
+ * operations to scale in and out.
+ *
+ * Error bounds (interpolation h^2/8 * max|f''| plus table rounding):
+ * - fastSin/fastCos: 129-entry quarter wave, |error| <= 3.5e-5
+ * - fastAtan2: 65-entry octant, |error| <= 3.5e-5 rad
+ * At our scale one wheel step is ~0.038 mm; a 3.5e-5 error over a 100 mm
+ * lever arm is 0.0035 mm, more than ten times below a step.
+ *
+ * sqrt is not replaced: avr-libc's sqrt already costs about one float
+ * divide, which any table or Newton scheme would also need.
+ *
+ * Compile with TERRAPEN_FAST_MATH to route Position and the robot's
+ * planning through these functions (TP_SIN/TP_COS/TP_ATAN2, and
+ * TP_SIN_BAM/TP_COS_BAM for binary-angle headings); without it
+ * they use libm, e.g. for the math validation build.
+ *
+ * Usage:
+ *   float s = fastSin(angle);
+ *   float bearing = TP_ATAN2(dx, dy);  // Library convention: atan2(x, y)
+ */
+
+#define FAST_SIN_QUARTER_STEPS 128               // Table steps per quarter turn
+#define FAST_ATAN_STEPS 64                       // Table steps over tan 0..1
+
+/**
+ * Sine of an angle in radians
+ */
+float fastSin(float angle);
+
+/**
+ * Cosine of an angle in radians
+ */
+float fastCos(float angle);
+
+/**
+ * Sine of a binary angle - no float work before the table lookup
+ */
+float fastSinBam(bam_t angle);
+
+/**
+ * Cosine of a binary angle
+ */
+float fastCosBam(bam_t angle);
+
+/**
+ * Four-quadrant arctangent of y/x in radians, [-PI, PI]
+ */
+float fastAtan2(float y, float x);
+
+// === COMPILE-TIME SWITCH ===
+#ifdef TERRAPEN_FAST_MATH
+#define TP_SIN(a) fastSin(a)
+#define TP_COS(a) fastCos(a)
+#define TP_ATAN2(y, x) fastAtan2(y, x)
+#define TP_SIN_BAM(a) fastSinBam(a)
+#define TP_COS_BAM(a) fastCosBam(a)
+#else
+#define TP_SIN(a) sin(a)
+#define TP_COS(a) cos(a)
+#define TP_ATAN2(y, x) atan2(y, x)
+#define TP_SIN_BAM(a) sin(bamToRadians(a))
+#define TP_COS_BAM(a) cos(bamToRadians(a))
+#endif
+
+#endif // FAST_MATH_H
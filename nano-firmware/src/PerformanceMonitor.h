@@ -43,6 +43,9 @@ struct PerformanceMetrics {
     float motor_load_percent;              // Motor utilization %
     int missed_steps_total;                // Steps that couldn't execute on time
     int timing_violations;                 // Times when timing was violated
+    int task_overruns;                     // Scheduled tasks finished past their deadline
+    unsigned long task_overrun_max_us;     // Worst time past a deadline
+    uint8_t last_overrun_task;             // Scheduler id of the latest overrun
     
     // Statistical data
     unsigned long total_updates;           // Total update() calls since reset
@@ -67,6 +70,9 @@ struct PerformanceMetrics {
         motor_load_percent = 0.0;
         missed_steps_total = 0;
         timing_violations = 0;
+        task_overruns = 0;
+        task_overrun_max_us = 0;
+        last_overrun_task = 0;
         total_updates = 0;
         total_runtime_ms = 0;
         last_reset_time_ms = millis();
@@ -207,6 +213,17 @@ public:
         metrics.timing_violations++;
     }
     
+    /**
+     * Report a scheduled task that finished past its deadline
+     */
+    void reportTaskOverrun(uint8_t task_id, unsigned long late_us) {
+        metrics.task_overruns++;
+        metrics.last_overrun_task = task_id;
+        if (late_us > metrics.task_overrun_max_us) {
+            metrics.task_overrun_max_us = late_us;
+        }
+    }
+    
     /**
      * Update motor load percentage based on current activity
      */
@@ -310,6 +327,14 @@ public:
             Serial.println(m.timing_violations);
         }
         
+        if (m.task_overruns > 0) {
+            Serial.print("⚠️ Task Overruns: ");
+            Serial.print(m.task_overruns);
+            Serial.print(" (worst ");
+            Serial.print(m.task_overrun_max_us);
+            Serial.println(" μs late)");
+        }
+        
         Serial.println("===========================");
     }
     
@@ -376,6 +401,13 @@ public:
         Serial.println(m.missed_steps_total);
         Serial.print("  Timing Violations: ");
         Serial.println(m.timing_violations);
+        Serial.print("  Task Overruns: ");
+        Serial.print(m.task_overruns);
+        Serial.print(" (worst ");
+        Serial.print(m.task_overrun_max_us);
+        Serial.print("μs, last task ");
+        Serial.print(m.last_overrun_task);
+        Serial.println(")");
         
         // Statistics
         Serial.println("STATISTICS:");
@@ -402,6 +434,7 @@ public:
         json += "\"free_memory\":" + String(m.free_memory_bytes) + ",";
         json += "\"missed_steps\":" + String(m.missed_steps_total) + ",";
         json += "\"timing_violations\":" + String(m.timing_violations) + ",";
+        json += "\"task_overruns\":" + String(m.task_overruns) + ",";
         json += "\"motor_load\":" + String(m.motor_load_percent) + ",";
         json += "\"total_updates\":" + String(m.total_updates) + ",";
         json += "\"runtime_ms\":" + String(m.total_runtime_ms);
@@ -488,6 +521,7 @@ extern PerformanceMonitor g_performance_monitor;
 #define PERF_END_LOOP() g_performance_monitor.endLoop()
 #define PERF_REPORT_MISSED_STEP() g_performance_monitor.reportMissedStep()
 #define PERF_REPORT_TIMING_VIOLATION() g_performance_monitor.reportTimingViolation()
+#define PERF_REPORT_TASK_OVERRUN(id, late_us) g_performance_monitor.reportTaskOverrun(id, late_us)
 #define PERF_PRINT_SUMMARY() g_performance_monitor.printSummary()
 
 #endif // PERFORMANCE_MONITOR_H
\ No newline at end of file
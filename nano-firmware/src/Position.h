@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <math.h>
+#include "FastMath.h"
 
 /**
  * Position - Robot position and orientation in 2D space
@@ -70,7 +71,7 @@ struct Position {
     float angleTo(const Position& other) const {
         float dx = other.x - x;
         float dy = other.y - y;
-        return atan2(dx, dy);  // Note: atan2(x, y) for our coordinate system
+        return TP_ATAN2(dx, dy);  // Note: atan2(x, y) for our coordinate system
     }
     
     /**
@@ -80,13 +81,9 @@ struct Position {
      */
     float turnAngleTo(const Position& other) const {
         float target_angle = angleTo(other);
-        float turn_angle = target_angle - angle;
         
-        // Normalize to [-PI, PI]
-        while (turn_angle > PI) turn_angle -= 2 * PI;
-        while (turn_angle < -PI) turn_angle += 2 * PI;
-        
-        return turn_angle;
+        // Shortest turn, wrapped through a binary angle
+        return wrapRadians(target_angle - angle);
     }
     
     // === POSITION MANIPULATION ===
@@ -116,8 +113,8 @@ struct Position {
      * @return New position after forward movement
      */
     Position moveForward(float distance) const {
-        float new_x = x + distance * sin(angle);
-        float new_y = y + distance * cos(angle);
+        float new_x = x + distance * TP_SIN(angle);
+        float new_y = y + distance * TP_COS(angle);
         return Position(new_x, new_y, angle);
     }
     
@@ -127,13 +124,7 @@ struct Position {
      * @return New position with updated orientation
      */
     Position rotate(float delta_angle) const {
-        float new_angle = angle + delta_angle;
-        
-        // Normalize angle to [-PI, PI]
-        while (new_angle > PI) new_angle -= 2 * PI;
-        while (new_angle < -PI) new_angle += 2 * PI;
-        
-        return Position(x, y, new_angle);
+        return Position(x, y, wrapRadians(angle + delta_angle));
     }
     
     // === COMPARISON OPERATORS ===
@@ -215,11 +206,10 @@ struct Position {
     }
     
     /**
-     * Normalize angle to [-PI, PI] range
+     * Normalize angle to [-PI, PI) range
      */
     void normalizeAngle() {
-        while (angle > PI) angle -= 2 * PI;
-        while (angle < -PI) angle += 2 * PI;
+        angle = wrapRadians(angle);
     }
     
     // === STATIC UTILITY FUNCTIONS ===
@@ -232,8 +222,8 @@ struct Position {
      * @return Position at specified polar coordinates
      */
     static Position fromPolar(float distance, float angle_rad, float orientation = 0) {
-        float x_pos = distance * sin(angle_rad);
-        float y_pos = distance * cos(angle_rad);
+        float x_pos = distance * TP_SIN(angle_rad);
+        float y_pos = distance * TP_COS(angle_rad);
         return Position(x_pos, y_pos, orientation);
     }
     
@@ -252,9 +242,7 @@ struct Position {
         float y_interp = start.y + t * (end.y - start.y);
         
         // Interpolate angle (handle wraparound)
-        float angle_diff = end.angle - start.angle;
-        while (angle_diff > PI) angle_diff -= 2 * PI;
-        while (angle_diff < -PI) angle_diff += 2 * PI;
+        float angle_diff = wrapRadians(end.angle - start.angle);
         float angle_interp = start.angle + t * angle_diff;
         
         return Position(x_interp, y_interp, angle_interp);
@@ -0,0 +1,70 @@
+#include "PowerManager.h"
+#include "TerraPenConfig.h"
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+PowerManager::PowerManager() :
+    robot(nullptr),
+    idle_since_ms(0),
+    last_left_steps(0),
+    last_right_steps(0),
+    coils_reduced(false)
+{
+}
+
+void PowerManager::begin(TerraPenRobot* robot_instance) {
+    robot = robot_instance;
+    idle_since_ms = millis();
+    coils_reduced = false;
+    
+    if (robot) {
+        last_left_steps = robot->getLeftStepsTotal();
+        last_right_steps = robot->getRightStepsTotal();
+    }
+}
+
+void PowerManager::update() {
+    if (!robot) return;
+    
+    // Any step restarts the timeout, even from a move too short to see MOVING
+    long left = robot->getLeftStepsTotal();
+    long right = robot->getRightStepsTotal();
+    if (robot->getState() != IDLE || left != last_left_steps || right != last_right_steps) {
+        last_left_steps = left;
+        last_right_steps = right;
+        idle_since_ms = millis();
+        coils_reduced = false;  // The step engine restored full hold
+        return;
+    }
+    
+    if (coils_reduced || !g_config.hardware.enable_power_saving) {
+        return;
+    }
+    
+    if (millis() - idle_since_ms >= g_config.hardware.motor_sleep_timeout_ms) {
+        robot->setIdleHold(g_config.hardware.motor_hold_current_percent);
+        coils_reduced = true;
+    }
+}
+
+void PowerManager::sleep() {
+    if (!robot || !g_config.hardware.enable_power_saving || robot->getState() == MOVING) {
+        return;
+    }
+
+#if defined(__AVR__)
+    // Peripherals keep running in idle mode, so UART receive and the
+    // millis() tick wake the CPU. An interrupt landing just before
+    // sleep_cpu() only delays the wake to the next millis() tick.
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+#endif
+}
+
+bool PowerManager::isCoilPowerReduced() const {
+    return coils_reduced;
+}
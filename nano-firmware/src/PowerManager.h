@@ -0,0 +1,57 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "robot/TerraPenRobot.h"
+
+/**
+ * Idle Power Management
+ *
+ * Cuts power while the robot has nothing to do:
+ * - After motor_sleep_timeout_ms without steps, the coil hold current drops
+ *   to motor_hold_current_percent (0 releases the coils and stops the step
+ *   timer). Full current returns as soon as the next block starts.
+ * - Between main loop passes the MCU sleeps in SLEEP_MODE_IDLE until the
+ *   next interrupt (UART receive, millis() tick or step timer). The step
+ *   timer ticks every 50 us at full hold, every STEP_ENGINE_HOLD_TICK_US
+ *   (500 us) while chopping a reduced hold and not at all at 0%, so sleep
+ *   saves most once the coil timeout has run.
+ *
+ * Both are skipped when g_config.hardware.enable_power_saving is false.
+ * Less hold current also keeps the 28BYJ coils cooler, which preserves
+ * their top speed.
+ */
+class PowerManager {
+private:
+    TerraPenRobot* robot;
+    unsigned long idle_since_ms;   // Last time the robot moved or was busy
+    long last_left_steps;          // Step totals at the last update
+    long last_right_steps;
+    bool coils_reduced;            // Hold current lowered for this idle period
+    
+public:
+    PowerManager();
+    
+    /**
+     * Attach the robot whose motors are managed
+     */
+    void begin(TerraPenRobot* robot_instance);
+    
+    /**
+     * Apply the coil timeout (call periodically, e.g. every 100 ms)
+     */
+    void update();
+    
+    /**
+     * Sleep until the next interrupt unless the robot is moving
+     * Call once per main loop pass, after the due tasks have run.
+     */
+    void sleep();
+    
+    /**
+     * Check if the coil hold current is currently reduced
+     */
+    bool isCoilPowerReduced() const;
+};
+
+#endif // POWER_MANAGER_H
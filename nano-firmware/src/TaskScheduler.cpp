@@ -0,0 +1,96 @@
+#include "TaskScheduler.h"
+#include "PerformanceMonitor.h"
+
+TaskScheduler::TaskScheduler() : task_count(0) {
+}
+
+int8_t TaskScheduler::addTask(TaskFunction function, unsigned long period_us, unsigned long deadline_us,
+                              TaskPriority priority) {
+    if (function == nullptr || task_count >= TASK_SCHEDULER_MAX_TASKS) {
+        return -1;
+    }
+    
+    // Insert after every task of the same or higher priority
+    uint8_t index = task_count;
+    while (index > 0 && tasks[index - 1].priority > priority) {
+        tasks[index] = tasks[index - 1];
+        index--;
+    }
+    
+    ScheduledTask& task = tasks[index];
+    task.function = function;
+    task.period_us = period_us;
+    task.deadline_us = deadline_us;
+    task.next_release_us = micros() + period_us;
+    task.max_run_us = 0;
+    task.overruns = 0;
+    task.priority = priority;
+    task.id = task_count;
+    return task_count++;
+}
+
+bool TaskScheduler::run() {
+    bool ran = false;
+    unsigned long pass_us = micros();
+    
+    for (uint8_t i = 0; i < task_count; i++) {
+        ScheduledTask& task = tasks[i];
+        unsigned long start_us = micros();
+        if ((long)(start_us - task.next_release_us) < 0) {
+            continue;
+        }
+        
+        unsigned long release_us = task.next_release_us;
+        task.function();
+        unsigned long end_us = micros();
+        ran = true;
+        
+        unsigned long run_us = end_us - start_us;
+        if (run_us > task.max_run_us) {
+            task.max_run_us = run_us;
+        }
+        
+        // Lateness counts from when the task became runnable: its release,
+        // or this pass's start if it was released before (while the loop
+        // slept or finished an earlier pass). Waiting behind higher-priority
+        // tasks in this pass counts; sleep and earlier passes do not.
+        unsigned long runnable_us = ((long)(release_us - pass_us) > 0) ? release_us : pass_us;
+        unsigned long finish_us = end_us - runnable_us;
+        if (task.deadline_us > 0 && finish_us > task.deadline_us) {
+            if (task.overruns < UINT16_MAX) task.overruns++;
+            PERF_REPORT_TASK_OVERRUN(task.id, finish_us - task.deadline_us);
+        }
+        
+        // Keep the cadence; a task already past its next release skips it
+        // rather than running back to back (every-pass tasks land here too)
+        task.next_release_us = release_us + task.period_us;
+        if ((long)(end_us - task.next_release_us) >= 0) {
+            task.next_release_us = end_us + task.period_us;
+        }
+    }
+    
+    return ran;
+}
+
+uint16_t TaskScheduler::getOverruns(int8_t id) const {
+    const ScheduledTask* task = findTask(id);
+    return task ? task->overruns : 0;
+}
+
+unsigned long TaskScheduler::getMaxRunTime(int8_t id) const {
+    const ScheduledTask* task = findTask(id);
+    return task ? task->max_run_us : 0;
+}
+
+uint8_t TaskScheduler::getTaskCount() const {
+    return task_count;
+}
+
+const ScheduledTask* TaskScheduler::findTask(int8_t id) const {
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (tasks[i].id == id) {
+            return &tasks[i];
+        }
+    }
+    return nullptr;
+}
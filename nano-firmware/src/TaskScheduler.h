@@ -0,0 +1,84 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+/**
+ * Cooperative Multi-Rate Task Scheduler
+ *
+ * Runs the firmware's subsystems from loop() without a fixed sleep. Each
+ * task has a period, a deadline and a priority:
+ * - run() makes one pass in priority order, running each due task once,
+ *   so motion never waits for more than one run of each lower task
+ * - Tasks are plain functions and must return promptly; nothing is preempted
+ * - A run that finishes later than its deadline after the task became
+ *   runnable is an overrun, counted per task and reported to
+ *   PerformanceMonitor. A task becomes runnable at its release, or at the
+ *   start of the first pass after it if the loop was asleep or busy then:
+ *   the deadline bounds the wait behind higher-priority tasks plus the
+ *   task's own run, not how long the loop slept
+ */
+
+#ifndef TASK_SCHEDULER_MAX_TASKS
+#define TASK_SCHEDULER_MAX_TASKS 6               // Task table size (fixed, no heap)
+#endif
+
+/**
+ * Task priorities, highest first
+ */
+enum TaskPriority : uint8_t {
+    TASK_PRIORITY_MOTION = 0,      // Robot state machine and step schedule refill
+    TASK_PRIORITY_COMMAND = 1,     // Host command reception
+    TASK_PRIORITY_TELEMETRY = 2,   // Periodic status reports
+    TASK_PRIORITY_BACKGROUND = 3   // NVRAM maintenance and uploads
+};
+
+typedef void (*TaskFunction)();
+
+/**
+ * One registered task
+ */
+struct ScheduledTask {
+    TaskFunction function;
+    unsigned long period_us;       // Release interval (0 = every pass)
+    unsigned long deadline_us;     // Latest finish after becoming runnable (0 = not checked)
+    unsigned long next_release_us;
+    unsigned long max_run_us;      // Longest single run seen
+    uint16_t overruns;             // Runs that finished past their deadline
+    TaskPriority priority;
+    uint8_t id;                    // Registration order, stable across insertions
+};
+
+class TaskScheduler {
+private:
+    ScheduledTask tasks[TASK_SCHEDULER_MAX_TASKS]; // Kept sorted by priority
+    uint8_t task_count;
+    
+public:
+    TaskScheduler();
+    
+    /**
+     * Register a task, first released one period from now
+     * Tasks of equal priority run in registration order.
+     * @return Task id, or -1 if the table is full
+     */
+    int8_t addTask(TaskFunction function, unsigned long period_us, unsigned long deadline_us,
+                   TaskPriority priority);
+    
+    /**
+     * Run every due task once, highest priority first
+     * Call from loop() as often as possible.
+     * @return false if no task was due
+     */
+    bool run();
+    
+    // === STATISTICS ===
+    uint16_t getOverruns(int8_t id) const;     // Overruns since registration
+    unsigned long getMaxRunTime(int8_t id) const; // Longest run in microseconds
+    uint8_t getTaskCount() const;
+    
+private:
+    const ScheduledTask* findTask(int8_t id) const;
+};
+
+#endif // TASK_SCHEDULER_H
@@ -35,6 +35,8 @@ void TerraPenConfig::printConfiguration() {
     Serial.println();
     Serial.print("Servo pin: "); Serial.println(hardware.servo_pin);
     Serial.print("Wheel diameter: "); Serial.print(hardware.wheel_diameter_mm); Serial.println(" mm");
+    Serial.print("Wheel scale L/R: "); Serial.print(hardware.left_wheel_scale, 4);
+    Serial.print(" / "); Serial.println(hardware.right_wheel_scale, 4);
     Serial.print("Wheelbase: "); Serial.print(hardware.wheelbase_mm); Serial.println(" mm");
     Serial.print("Steps per revolution: "); Serial.println(hardware.steps_per_revolution);
     Serial.print("Step delay range: "); Serial.print(hardware.min_step_delay_us);
@@ -189,4 +191,11 @@ uint32_t TerraPenConfig::calculateChecksum() {
     }
     
     return checksum;
-}
\ No newline at end of file
+}
+
+float TerraPenConfig::getCruiseSpeedMms() const {
+    // Mean calibrated wheel travel per step, one step every step_delay_us
+    float scale = (hardware.left_wheel_scale + hardware.right_wheel_scale) * 0.5f;
+    float mm_per_step = PI * hardware.wheel_diameter_mm * scale / hardware.steps_per_revolution;
+    return mm_per_step * 1000000.0f / hardware.step_delay_us;
+}
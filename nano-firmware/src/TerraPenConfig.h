@@ -36,17 +36,32 @@ struct HardwareConfig {
     uint16_t servo_pen_up_angle = 90;            // Degrees for pen up position
     uint16_t servo_pen_down_angle = 45;          // Degrees for pen down position
     uint16_t servo_move_speed_ms = 500;          // Time for pen up/down movement
+    uint8_t pen_lift_clear_percent = 40;         // Travel may start once a lift is this far along
     
     // === PHYSICAL PARAMETERS ===
-    float wheel_diameter_mm = 25.0f;             // Wheel diameter in millimeters
+    float wheel_diameter_mm = 25.0f;             // Nominal wheel diameter in millimeters
+    float left_wheel_scale = 1.0f;               // Calibrated effective / nominal diameter, left wheel
+    float right_wheel_scale = 1.0f;              // Calibrated effective / nominal diameter, right wheel
     float wheelbase_mm = 30.0f;                  // Distance between wheel centers
     uint16_t steps_per_revolution = 2048;        // Steps for 360° rotation (28BYJ-48)
     
     // === MOTOR TIMING ===
-    uint16_t step_delay_us = 1000;               // Microseconds between steps (max speed)
+    uint16_t step_delay_us = 600;                // Microseconds between steps (cruise speed, default for moves)
     uint16_t min_step_delay_us = 600;            // Minimum step delay (hardware limit)
     uint16_t max_step_delay_us = 10000;          // Maximum step delay (slowest speed)
-    uint16_t acceleration_steps = 50;            // Steps to reach full speed
+    // The ramp table holds STEP_ENGINE_RAMP_MAX (64) steps; a longer ramp keeps
+    // its acceleration but stops short of min_step_delay_us, so ramped moves
+    // top out at a longer delay (below the configured cruise speed)
+    uint16_t acceleration_steps = 50;            // Steps to reach full speed (0 = no ramp)
+    // Junction look-ahead only links trapezoid blocks; with the S-curve every
+    // block starts and ends at the ramp's start speed
+    uint8_t motion_profile = 1;                  // 0 = constant, 1 = trapezoid, 2 = S-curve
+    
+    // === PATH FOLLOWING ===
+    uint8_t path_mode = 0;                       // 0 = spot turns, 1 = curvature tracking
+    float tracking_lookahead_mm = 4.0f;          // Pure-pursuit lookahead distance
+    float tracking_corner_rad = 0.6f;            // Sharper bends stop and turn in place
+    uint8_t reverse_mode = 0;                    // Back up to targets >90° off heading: 0 = never, 1 = travel, 2 = travel and draw
     
     // === SAFETY LIMITS ===
     uint32_t max_continuous_steps = 50000;       // Maximum steps before mandatory pause
@@ -211,6 +226,7 @@ struct TerraPenConfig {
     bool validateConfiguration();
     void resetToDefaults();
     uint32_t calculateChecksum();
+    float getCruiseSpeedMms() const;             // Wheel speed at step_delay_us (default move speed)
     
     // === CONDITIONAL COMPILATION HELPERS ===
     #if defined(DEBUG) || defined(_DEBUG)
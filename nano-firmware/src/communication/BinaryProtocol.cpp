@@ -0,0 +1,196 @@
+/**
+ * Binary Command Framing Implementation
+ */
+
+#include "BinaryProtocol.h"
+
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
+
+// === FRAMING ===
+
+uint16_t crc16(const uint8_t* data, uint8_t length) {
+    uint16_t crc = 0xFFFF;
+    
+    for (uint8_t i = 0; i < length; i++) {
+#if defined(__AVR__)
+        crc = _crc_xmodem_update(crc, data[i]);  // Same polynomial, hand-tuned assembly
+#else
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+#endif
+    }
+    return crc;
+}
+
+uint8_t cobsEncode(const uint8_t* data, uint8_t length, uint8_t* out) {
+    uint8_t code_index = 0;
+    uint8_t write = 1;
+    uint8_t code = 1;
+    
+    for (uint8_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            out[write++] = data[i];
+            code++;
+        }
+        
+        // A zero, or a full run of 254 data bytes, closes the current block;
+        // a full run at the very end needs no empty block after it
+        if (data[i] == 0 || (code == 0xFF && i + 1 < length)) {
+            out[code_index] = code;
+            code_index = write++;
+            code = 1;
+        }
+    }
+    
+    out[code_index] = code;
+    return write;
+}
+
+uint8_t cobsDecode(uint8_t* data, uint8_t length) {
+    uint8_t read = 0;
+    uint8_t write = 0;
+    
+    // Output never overtakes input, so decoding in place is safe
+    while (read < length) {
+        uint8_t code = data[read++];
+        if (code == 0 || read + code - 1 > length) {
+            return 0;
+        }
+        
+        for (uint8_t i = 1; i < code; i++) {
+            data[write++] = data[read++];
+        }
+        
+        // Every block but a full one and the last stands for a zero
+        if (code != 0xFF && read < length) {
+            data[write++] = 0;
+        }
+    }
+    return write;
+}
+
+bool unpackFrame(uint8_t* frame, uint8_t& length) {
+    uint8_t decoded = cobsDecode(frame, length);
+    if (decoded < 3) {
+        return false;  // Opcode and CRC at least
+    }
+    
+    length = decoded - 2;
+    uint16_t received = (uint16_t)frame[length] | ((uint16_t)frame[length + 1] << 8);
+    return crc16(frame, length) == received;
+}
+
+void sendFrame(Print& port, const uint8_t* message, uint8_t length) {
+    uint8_t raw[BINARY_FRAME_MAX];
+    uint8_t encoded[BINARY_FRAME_ENCODED_MAX];
+    if (length > BINARY_FRAME_MAX - 2) {
+        return;
+    }
+    
+    memcpy(raw, message, length);
+    writeUint16LE(raw + length, crc16(message, length));
+    uint8_t encoded_length = cobsEncode(raw, length + 2, encoded);
+    
+    port.write((uint8_t)0);
+    port.write(encoded, encoded_length);
+    port.write((uint8_t)0);
+}
+
+int8_t binaryPayloadSize(uint8_t opcode) {
+    switch (opcode) {
+        case BIN_MOVE_TO:
+        case BIN_DRAW_TO:
+            return 4;
+        case BIN_SET_PEN:
+            return 1;
+        case BIN_GET_POSITION:
+        case BIN_HOME:
+        case BIN_EMERGENCY_STOP:
+        case BIN_GET_STATUS:
+            return 0;
+        case BIN_SET_ROBOT_PARAMETERS:
+            return 13;
+        case BIN_ARC_TO:
+            return 9;
+        case BIN_SET_PATH_MODE:
+            return 3;
+        case BIN_CURVE_TO:
+            return 12;
+        default:
+            return -1;
+    }
+}
+
+bool binaryPayloadValid(uint8_t opcode, uint8_t length) {
+    int8_t size = binaryPayloadSize(opcode);
+    if (size < 0) return false;
+    if (length == size) return true;
+    
+    // Optional uint16 speed after the fixed fields
+    return (opcode == BIN_MOVE_TO || opcode == BIN_DRAW_TO || opcode == BIN_ARC_TO || opcode == BIN_CURVE_TO) &&
+           length == size + 2;
+}
+
+// === LITTLE-ENDIAN FIELDS ===
+
+int16_t readInt16LE(const uint8_t* data) {
+    return (int16_t)readUint16LE(data);
+}
+
+uint16_t readUint16LE(const uint8_t* data) {
+    return (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+}
+
+float readFloatLE(const uint8_t* data) {
+    // AVR float is IEEE 754 single precision, stored little-endian
+    float value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+void writeInt16LE(uint8_t* data, int16_t value) {
+    writeUint16LE(data, (uint16_t)value);
+}
+
+void writeUint16LE(uint8_t* data, uint16_t value) {
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+void writeUint32LE(uint8_t* data, uint32_t value) {
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+// === UNIT CONVERSION ===
+
+float binaryToMm(int16_t value) {
+    return value * (1.0f / BINARY_MM_SCALE);
+}
+
+float binaryToSpeed(uint16_t value) {
+    return value * (1.0f / BINARY_SPEED_SCALE);
+}
+
+/**
+ * Round a scaled value to int16, saturating at the ends of the range
+ */
+static int16_t toInt16(float scaled) {
+    if (scaled >= 32767.0f) return 32767;
+    if (scaled <= -32768.0f) return -32768;
+    return (int16_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+}
+
+int16_t mmToBinary(float mm) {
+    return toInt16(mm * BINARY_MM_SCALE);
+}
+
+int16_t radiansToBinary(float radians) {
+    return toInt16(radians * BINARY_RAD_SCALE);
+}
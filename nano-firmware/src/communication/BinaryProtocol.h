@@ -0,0 +1,116 @@
+/**
+ * Binary Command Framing
+ *
+ * Compact alternative to the JSON line protocol on the same UART:
+ *
+ *   0x00 | COBS( opcode | payload | CRC16 ) | 0x00
+ *
+ * - COBS removes every zero byte, so 0x00 only ever delimits frames. JSON
+ *   lines never contain one, so a leading 0x00 tells the reader that a
+ *   binary frame follows; every frame must start with it
+ * - CRC16-CCITT (poly 0x1021, init 0xFFFF) over opcode and payload,
+ *   little-endian
+ * - Opcodes reuse the JSON "cmd" and "response" numbers
+ * - Payload fields are fixed-size little-endian: coordinates are int16 in
+ *   0.01 mm, angles int16 in 0.0001 rad, speeds uint16 in 0.01 mm/s
+ * - MOVE_TO, DRAW_TO, ARC_TO and CURVE_TO may append a speed; without it
+ *   the robot uses its configured cruise speed
+ */
+
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <Arduino.h>
+
+#define BINARY_FRAME_MAX 32                      // Largest decoded frame (opcode + payload + CRC)
+#define BINARY_FRAME_ENCODED_MAX (BINARY_FRAME_MAX + 1) // COBS adds one byte per 254
+#define BINARY_MM_SCALE 100.0f                   // int16 units per mm (range +-327 mm)
+#define BINARY_RAD_SCALE 10000.0f                // int16 units per radian (covers +-PI)
+#define BINARY_SPEED_SCALE 100.0f                // uint16 units per mm/s (up to 655 mm/s)
+
+/**
+ * Frame opcodes and their payloads
+ */
+enum BinaryOpcode : uint8_t {
+    // Commands (ESP32 -> Nano)
+    BIN_MOVE_TO = 1,              // int16 x, int16 y, optional uint16 speed
+    BIN_DRAW_TO = 2,              // int16 x, int16 y, optional uint16 speed
+    BIN_SET_PEN = 3,              // uint8 down
+    BIN_GET_POSITION = 4,         // (none)
+    BIN_HOME = 5,                 // (none)
+    BIN_EMERGENCY_STOP = 6,       // (none)
+    BIN_GET_STATUS = 7,           // (none)
+    BIN_SET_ROBOT_PARAMETERS = 9, // uint8 fields (1 left, 2 right, 4 wheelbase), float32 left, right, wheelbase
+    BIN_ARC_TO = 11,              // int16 cx, cy, x, y, uint8 clockwise, optional uint16 speed
+    BIN_SET_PATH_MODE = 12,       // uint8 fields (1 tracking, 2 reverse), uint8 tracking, uint8 reverse
+    BIN_CURVE_TO = 13,            // int16 c1x, c1y, c2x, c2y, x, y, optional uint16 speed
+    
+    // Responses (Nano -> ESP32)
+    BIN_ACK = 128,                // uint8 opcode
+    BIN_NACK = 129,               // uint8 opcode, uint8 ErrorCode
+    BIN_POSITION = 130,           // int16 x, y, angle, uint32 timestamp
+    BIN_STATUS = 131              // uint8 state, pen_down, queue_free, uint16 overruns, uint32 timestamp
+};
+
+// === FRAMING ===
+
+/**
+ * CRC16-CCITT (poly 0x1021, init 0xFFFF, no reflection)
+ */
+uint16_t crc16(const uint8_t* data, uint8_t length);
+
+/**
+ * COBS-encode a message (out needs length + 1 bytes, up to 254 bytes in)
+ * @return Encoded length, excluding delimiters
+ */
+uint8_t cobsEncode(const uint8_t* data, uint8_t length, uint8_t* out);
+
+/**
+ * COBS-decode a frame in place
+ * @return Decoded length, or 0 if the frame is malformed
+ */
+uint8_t cobsDecode(uint8_t* data, uint8_t length);
+
+/**
+ * Decode a received frame in place and check its CRC
+ * @param frame Encoded bytes between the delimiters; receives opcode + payload
+ * @param length Encoded length in, opcode + payload length out
+ * @return false if the frame is malformed or the CRC does not match
+ */
+bool unpackFrame(uint8_t* frame, uint8_t& length);
+
+/**
+ * Append the CRC, encode and write one frame with its delimiters
+ * @param message Opcode + payload (at most BINARY_FRAME_MAX - 2 bytes)
+ */
+void sendFrame(Print& port, const uint8_t* message, uint8_t length);
+
+/**
+ * Payload size of a command opcode, without optional fields
+ * @return Size in bytes, or -1 if the opcode is not a command
+ */
+int8_t binaryPayloadSize(uint8_t opcode);
+
+/**
+ * Check a command's payload length, allowing its optional trailing fields
+ * @return true if the payload can be read as this opcode
+ */
+bool binaryPayloadValid(uint8_t opcode, uint8_t length);
+
+// === LITTLE-ENDIAN FIELDS ===
+
+int16_t readInt16LE(const uint8_t* data);
+uint16_t readUint16LE(const uint8_t* data);
+float readFloatLE(const uint8_t* data);
+void writeInt16LE(uint8_t* data, int16_t value);
+void writeUint16LE(uint8_t* data, uint16_t value);
+void writeUint32LE(uint8_t* data, uint32_t value);
+
+// === UNIT CONVERSION ===
+
+float binaryToMm(int16_t value);
+float binaryToSpeed(uint16_t value);     // mm/s
+int16_t mmToBinary(float mm);            // Saturates outside +-327.67 mm
+int16_t radiansToBinary(float radians);  // Saturates outside +-3.2767 rad
+
+#endif // BINARY_PROTOCOL_H
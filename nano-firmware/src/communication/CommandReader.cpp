@@ -0,0 +1,72 @@
+#include "CommandReader.h"
+
+CommandReader::CommandReader() :
+    length(0),
+    mode(MODE_IDLE),
+    overflow(false)
+{
+}
+
+void CommandReader::start(ReaderMode new_mode) {
+    mode = new_mode;
+    length = 0;
+    overflow = false;
+}
+
+void CommandReader::append(uint8_t byte, uint8_t capacity) {
+    if (length < capacity) {
+        buffer[length++] = byte;
+    } else {
+        overflow = true;
+    }
+}
+
+CommandReaderResult CommandReader::read(Stream& port) {
+    while (port.available()) {
+        uint8_t c = port.read();
+        
+        if (c == 0) {
+            // Closes a frame, or opens one (dropping any partial JSON line)
+            if (mode == MODE_FRAME && (length > 0 || overflow)) {
+                mode = MODE_IDLE;
+                return overflow ? READ_FRAME_OVERFLOW : READ_FRAME;
+            }
+            if (mode != MODE_FRAME) {
+                start(MODE_FRAME);
+            }
+            continue;  // A repeated 0x00 just keeps waiting for the frame
+        }
+        
+        if (mode == MODE_FRAME) {
+            append(c, COMMAND_READER_SIZE);
+        } else if (c == '\n' || c == '\r') {
+            if (mode == MODE_LINE) {
+                mode = MODE_IDLE;
+                if (overflow) {
+                    return READ_LINE_OVERFLOW;
+                }
+                buffer[length] = '\0';
+                return READ_LINE;
+            }
+        } else {
+            if (mode == MODE_IDLE) {
+                start(MODE_LINE);
+            }
+            append(c, COMMAND_READER_SIZE - 1);  // Room for the terminator
+        }
+    }
+    
+    return READ_PENDING;
+}
+
+char* CommandReader::line() {
+    return (char*)buffer;
+}
+
+uint8_t* CommandReader::frame() {
+    return buffer;
+}
+
+uint8_t CommandReader::size() const {
+    return length;
+}
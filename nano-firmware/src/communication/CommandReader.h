@@ -0,0 +1,77 @@
+#ifndef COMMAND_READER_H
+#define COMMAND_READER_H
+
+#include <Arduino.h>
+
+/**
+ * Host Command Reader
+ *
+ * Collects JSON lines and binary frames from the UART in one static buffer:
+ * - A 0x00 starts a binary frame, which runs to the next 0x00; any other
+ *   byte starts a JSON line, which runs to '\n' or '\r'
+ * - A complete message is handed out as a view into the buffer and stays
+ *   valid until the next read(); lines are NUL-terminated in place
+ * - A message longer than the buffer is dropped up to its terminator and
+ *   reported once as an overflow, so the next message starts clean
+ *
+ * Nothing is allocated after construction.
+ */
+
+#ifndef COMMAND_READER_SIZE
+#define COMMAND_READER_SIZE 128                  // Longest JSON line (incl. NUL) or encoded frame
+#endif
+
+/**
+ * Outcome of a read() call
+ */
+enum CommandReaderResult : uint8_t {
+    READ_PENDING,          // Input exhausted, no message complete yet
+    READ_LINE,             // JSON line ready in line()
+    READ_FRAME,            // Binary frame ready in frame() (COBS-encoded, no delimiters)
+    READ_LINE_OVERFLOW,    // JSON line too long, discarded
+    READ_FRAME_OVERFLOW    // Binary frame too long, discarded
+};
+
+class CommandReader {
+private:
+    enum ReaderMode : uint8_t {
+        MODE_IDLE,         // Between messages
+        MODE_LINE,         // Inside a JSON line
+        MODE_FRAME         // Inside a binary frame
+    };
+    
+    uint8_t buffer[COMMAND_READER_SIZE];
+    uint8_t length;
+    ReaderMode mode;
+    bool overflow;         // Current message no longer fits
+    
+    void start(ReaderMode new_mode);
+    void append(uint8_t byte, uint8_t capacity);
+    
+public:
+    CommandReader();
+    
+    /**
+     * Consume input until a message completes or the port runs dry
+     * Returns as soon as one message is complete, so call again until
+     * READ_PENDING to drain the port.
+     */
+    CommandReaderResult read(Stream& port);
+    
+    /**
+     * Last complete JSON line (NUL-terminated, no line ending)
+     */
+    char* line();
+    
+    /**
+     * Last complete binary frame, decodable in place
+     */
+    uint8_t* frame();
+    
+    /**
+     * Length of the last complete message in bytes
+     */
+    uint8_t size() const;
+};
+
+#endif // COMMAND_READER_H
@@ -0,0 +1,87 @@
+#include "JsonArena.h"
+
+#define JSON_ARENA_WORDS (JSON_ARENA_SIZE / sizeof(size_t))
+#define JSON_ARENA_NONE ((size_t)-1)
+
+/**
+ * Words needed for a block of the given size, header included
+ */
+static size_t blockWords(size_t size) {
+    return 1 + (size + sizeof(size_t) - 1) / sizeof(size_t);
+}
+
+JsonArena::JsonArena() :
+    used(0),
+    newest(JSON_ARENA_NONE),
+    live_blocks(0),
+    peak(0)
+{
+}
+
+void* JsonArena::allocate(size_t size) {
+    size_t words = blockWords(size);
+    if (words > JSON_ARENA_WORDS - used) {
+        return nullptr;
+    }
+    
+    // Header holds the block's size for reallocate()
+    newest = used;
+    memory[newest] = size;
+    used += words;
+    live_blocks++;
+    if (used > peak) peak = used;
+    return &memory[newest + 1];
+}
+
+void JsonArena::deallocate(void* block) {
+    if (block == nullptr) return;
+    
+    // Only the newest block can be handed back early; the rest waits
+    // until the last document lets go
+    if (newest != JSON_ARENA_NONE && block == &memory[newest + 1]) {
+        used = newest;
+        newest = JSON_ARENA_NONE;
+    }
+    if (live_blocks > 0 && --live_blocks == 0) {
+        used = 0;
+        newest = JSON_ARENA_NONE;
+    }
+}
+
+void* JsonArena::reallocate(void* block, size_t new_size) {
+    if (block == nullptr) {
+        return allocate(new_size);
+    }
+    
+    size_t* head = (size_t*)block - 1;
+    size_t old_size = *head;
+    
+    // The newest block resizes in place; any other block can shrink in
+    // place but has to move to grow
+    if (newest != JSON_ARENA_NONE && block == &memory[newest + 1]) {
+        size_t words = blockWords(new_size);
+        if (words > JSON_ARENA_WORDS - newest) {
+            return nullptr;
+        }
+        *head = new_size;
+        used = newest + words;
+        if (used > peak) peak = used;
+        return block;
+    }
+    if (new_size <= old_size) {
+        *head = new_size;
+        return block;
+    }
+    
+    void* moved = allocate(new_size);
+    if (moved == nullptr) {
+        return nullptr;
+    }
+    memcpy(moved, block, old_size);
+    deallocate(block);
+    return moved;
+}
+
+size_t JsonArena::getPeakUsage() const {
+    return peak * sizeof(size_t);
+}
@@ -0,0 +1,45 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * Static Memory for JSON Documents
+ *
+ * ArduinoJson 7 documents take their memory from the heap unless given an
+ * allocator. JsonArena hands out blocks from a fixed array instead:
+ * - Blocks stack up; the newest can grow or shrink in place and is
+ *   reclaimed as soon as it is freed
+ * - Once every block is freed (all documents gone) the arena starts over,
+ *   so documents nested inside a command handler work as before
+ * - When the arena is full, allocation fails and ArduinoJson reports
+ *   NoMemory (parsing) or overflowed() (building)
+ */
+
+#ifndef JSON_ARENA_SIZE
+#define JSON_ARENA_SIZE 416                      // Largest command document plus one reply, with margin (test_json_arena.cpp)
+#endif
+
+class JsonArena : public ArduinoJson::Allocator {
+private:
+    size_t memory[JSON_ARENA_SIZE / sizeof(size_t)]; // Word-aligned storage
+    size_t used;           // Words in use, including block headers
+    size_t newest;         // Word offset of the newest block's header
+    uint8_t live_blocks;   // Blocks not yet freed
+    size_t peak;           // Largest use since boot, in words
+    
+public:
+    JsonArena();
+    
+    void* allocate(size_t size) override;
+    void deallocate(void* block) override;
+    void* reallocate(void* block, size_t new_size) override;
+    
+    /**
+     * Largest number of bytes in use at once since boot (tunes JSON_ARENA_SIZE)
+     */
+    size_t getPeakUsage() const;
+};
+
+#endif // JSON_ARENA_H
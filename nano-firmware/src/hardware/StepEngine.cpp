@@ -0,0 +1,754 @@
+#include "StepEngine.h"
+
+#if defined(__AVR__)
+#include <util/atomic.h>
+#define STEP_ENGINE_ATOMIC() ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#else
+#define STEP_ENGINE_ATOMIC()
+#endif
+
+#define STEP_ENGINE_QUEUE_MASK (STEP_ENGINE_QUEUE_SIZE - 1)
+
+// The incremental ramp formula is only approximate for the first step
+// (c[1] = 0.6 c[0] where constant acceleration gives 0.414 c[0]). Scaling
+// c[0] by this factor (D. Austin, "Generate stepper-motor speed profiles in
+// real time") puts the intervals after it back on the exact curve.
+#define STEP_ENGINE_FIRST_STEP_FACTOR 0.676f
+
+StepEngine* StepEngine::active_engine = nullptr;
+
+// === S-CURVE KNOT LAYOUT ===
+// The interval changes fastest at the slow end of the ramp, so the first
+// 2^shift steps are split at 1/8, 1/4 and 1/2 (fewer when that span is
+// short) before knots continue every 2^shift steps. Spans only ever double
+// in length from one to the next.
+
+static uint8_t subKnots(uint8_t shift) {
+    return (shift < 3) ? shift : 3;
+}
+
+// log2 of the length of the span starting at knot k
+static uint8_t spanShift(uint8_t shift, uint8_t k) {
+    uint8_t sub = subKnots(shift);
+    if (k > sub) return shift;
+    return (k == 0) ? shift - sub : shift - sub + k - 1;
+}
+
+// Step index of knot k from the start of the ramp
+static unsigned long knotPosition(uint8_t shift, uint8_t k) {
+    uint8_t sub = subKnots(shift);
+    if (k == 0) return 0;
+    if (k <= sub) return (1UL << shift) >> (sub - k + 1);
+    return (unsigned long)(k - sub) << shift;
+}
+
+// Catmull-Rom tangent at knot k, as the interval change over a span of
+// 2^span_shift steps. Zero at both ends, where acceleration is zero.
+static long knotTangent(const uint16_t* knots, const StepBlock& block, uint8_t k, uint8_t span_shift) {
+    uint8_t last = subKnots(block.knot_shift) + (block.ramp_steps >> block.knot_shift);
+    if (k == 0 || k >= last) return 0;
+    
+    long change = (long)knots[k + 1] - knots[k - 1];
+    uint8_t before = spanShift(block.knot_shift, k - 1);
+    if (spanShift(block.knot_shift, k) == before) return change / 2;
+    
+    // The next span is twice as long, so the knots either side are three
+    // short spans apart; multiply instead of dividing by 3 in the ISR
+    if (span_shift != before) change *= 2;
+    return (change * 21846L) >> 16;
+}
+
+StepEngine::StepEngine() :
+    left_motor(nullptr),
+    right_motor(nullptr),
+    queue_head(0),
+    queue_tail(0),
+    major_steps(0),
+    remaining(0),
+    step_index(0),
+    interval_us(0),
+    countdown_us(0),
+    block_active(false),
+    ramp_length(0),
+    ramp_min_interval_us(0),
+    ramp_top_interval_us(0),
+    ramp_steps_configured(0),
+    left_position(0),
+    right_position(0),
+    retired_blocks(0),
+    idle_hold_percent(100),
+    hold_accumulator(0),
+    hold_coils_on(true),
+    coils_released(false),
+    timer_paused(false),
+    hold_tick(false),
+    initialized(false),
+    last_service_us(0)
+{
+}
+
+void StepEngine::begin(StepperDriver* left, StepperDriver* right) {
+    left_motor = left;
+    right_motor = right;
+    
+    // Start with an empty schedule
+    queue_head = 0;
+    queue_tail = 0;
+    block_active = false;
+    remaining = 0;
+    left_position = 0;
+    right_position = 0;
+    retired_blocks = 0;
+    idle_hold_percent = 100;
+    coils_released = false;
+    timer_paused = false;
+    
+    active_engine = this;
+    initialized = true;
+    
+    startTimer();
+}
+
+void StepEngine::configureRamp(uint16_t start_interval_us, uint16_t min_interval_us, uint16_t ramp_steps) {
+    // Disable ramping while the table is rewritten
+    ramp_length = 0;
+    
+    if (ramp_steps == 0 || min_interval_us == 0 || start_interval_us <= min_interval_us) return;
+    ramp_min_interval_us = min_interval_us;
+    ramp_steps_configured = ramp_steps;
+    
+    // Constant acceleration reaching 1/min_interval after ramp_steps steps
+    // gives a first interval of 2 * min_interval * sqrt(ramp_steps), less
+    // the first-step correction. Later intervals use the incremental
+    // c[n] = c[n-1] - 2*c[n-1] / (4n + 1), so the table is built without a
+    // square root per step.
+    float interval = STEP_ENGINE_FIRST_STEP_FACTOR * 2.0f * min_interval_us * sqrt((float)ramp_steps);
+    
+    uint8_t length = 0;
+    for (uint16_t n = 0; n < ramp_steps && length < STEP_ENGINE_RAMP_MAX; n++) {
+        if (n > 0) {
+            interval -= (2.0f * interval) / (4.0f * n + 1.0f);
+        }
+        if (interval <= min_interval_us) break;
+        
+        ramp_table[length++] = (interval > start_interval_us) ? start_interval_us : (uint16_t)interval;
+    }
+    
+    // A ramp cut short by the table keeps its acceleration; blocks are
+    // limited to the last entry rather than jumping on to min_interval_us
+    ramp_top_interval_us = (length == STEP_ENGINE_RAMP_MAX) ? ramp_table[length - 1] : min_interval_us;
+    
+    // Publish only after the table is fully written
+    ramp_length = length;
+}
+
+bool StepEngine::queueBlock(long left_steps, long right_steps, uint16_t interval_us,
+                            MotionProfile profile) {
+    if (!initialized) return false;
+    
+    // Nothing to schedule
+    if (left_steps == 0 && right_steps == 0) return true;
+    
+    uint8_t next_head = (queue_head + 1) & STEP_ENGINE_QUEUE_MASK;
+    if (next_head == queue_tail) {
+        return false;  // Schedule full
+    }
+    
+    StepBlock& block = blocks[queue_head];
+    unsigned long left_delta = (left_steps >= 0) ? left_steps : -left_steps;
+    unsigned long right_delta = (right_steps >= 0) ? right_steps : -right_steps;
+    
+    block.left_steps = left_steps;
+    block.right_steps = right_steps;
+    block.interval_us = interval_us;
+    block.major_steps = (left_delta > right_delta) ? left_delta : right_delta;
+    block.profile = (ramp_length > 0) ? profile : PROFILE_CONSTANT;
+    if (block.profile != PROFILE_CONSTANT && block.interval_us < ramp_top_interval_us) {
+        block.interval_us = ramp_top_interval_us;  // Faster than the ramp can reach
+    }
+    block.ramp_steps = 0;
+    block.entry_index = 0;
+    block.exit_index = 0;
+    block.junction_index = 0;
+    
+    if (block.profile == PROFILE_SCURVE) {
+        // One knot table: wait until the queued S-curve block has run
+        if (hasSCurveBlock()) return false;
+        planSCurve(block, block.major_steps);
+    }
+    
+    // Blocks queued behind another may start at speed
+    block.cruise_index = rampIndexFor(block.interval_us);
+    if (queue_head != queue_tail) {
+        block.junction_index = junctionIndex(blocks[(queue_head - 1) & STEP_ENGINE_QUEUE_MASK], block);
+    }
+    
+    // Publish only after the block is fully written
+    queue_head = next_head;
+    
+    replan();
+    
+    // Idle with the coils released or chopped; the step tick loads this
+    // block on its next pass
+    if (timer_paused || hold_tick) {
+        timer_paused = false;
+        startTimer();
+    }
+    return true;
+}
+
+void StepEngine::stop() {
+    STEP_ENGINE_ATOMIC() {
+        queue_tail = queue_head;
+        block_active = false;
+        remaining = 0;
+    }
+}
+
+void StepEngine::release() {
+    if (!initialized) return;
+    
+    // One atomic block, so no tick can chop the coils back on in between
+    STEP_ENGINE_ATOMIC() {
+        queue_tail = queue_head;
+        block_active = false;
+        remaining = 0;
+        left_motor->release();
+        right_motor->release();
+        idle_hold_percent = 0;
+        hold_coils_on = false;
+        coils_released = true;
+        pauseTimer();
+    }
+}
+
+void StepEngine::setIdleHold(uint8_t percent) {
+    if (!initialized) return;
+    if (percent > 100) percent = 100;
+    
+    // Coils released by release() stay released until the next block
+    if (coils_released) return;
+    
+    STEP_ENGINE_ATOMIC() {
+        // Back to full hold re-energises coils a chop may have left off
+        if (percent == 100 && !hold_coils_on) {
+            left_motor->hold();
+            right_motor->hold();
+        }
+        idle_hold_percent = percent;
+        hold_accumulator = 0;
+        hold_coils_on = true;
+    }
+    
+    // Released coils restart on the tick; the first chop tick applies the rest
+    if (percent == 100 && (timer_paused || hold_tick)) {
+        timer_paused = false;
+        startTimer();
+    } else if (percent > 0 && percent < 100 && !timer_paused && isIdle()) {
+        startHoldTimer();
+    }
+}
+
+bool StepEngine::isIdle() const {
+    bool idle;
+    STEP_ENGINE_ATOMIC() {
+        idle = !block_active && (queue_head == queue_tail);
+    }
+    return idle;
+}
+
+bool StepEngine::isStopping() const {
+    bool stopping;
+    STEP_ENGINE_ATOMIC() {
+        if (!block_active) {
+            stopping = (queue_head == queue_tail);
+        } else if (((queue_tail + 1) & STEP_ENGINE_QUEUE_MASK) != queue_head) {
+            stopping = false;  // More blocks follow this one
+        } else {
+            const StepBlock& block = blocks[queue_tail];
+            unsigned long to_end = remaining - 1;
+            
+            if (block.profile == PROFILE_TRAPEZOID) {
+                // Deceleration index has dropped below both acceleration and cruise
+                unsigned long accel_index = block.entry_index + step_index;
+                unsigned long decel_index = block.exit_index + to_end;
+                stopping = (decel_index < accel_index) && (decel_index < block.cruise_index);
+            } else {
+                unsigned long ramp = (block.profile == PROFILE_SCURVE) ? block.ramp_steps : ramp_steps_configured;
+                stopping = (to_end < step_index) && (to_end < ramp);
+            }
+        }
+    }
+    return stopping;
+}
+
+uint16_t StepEngine::getStepInterval() const {
+    uint16_t interval = 0;
+    STEP_ENGINE_ATOMIC() {
+        if (block_active) interval = nextInterval();
+    }
+    return interval;
+}
+
+uint8_t StepEngine::getFreeSlots() const {
+    return (queue_tail - queue_head - 1) & STEP_ENGINE_QUEUE_MASK;
+}
+
+long StepEngine::getLeftPosition() const {
+    long position;
+    STEP_ENGINE_ATOMIC() {
+        position = left_position;
+    }
+    return position;
+}
+
+long StepEngine::getRightPosition() const {
+    long position;
+    STEP_ENGINE_ATOMIC() {
+        position = right_position;
+    }
+    return position;
+}
+
+void StepEngine::getProgress(uint8_t& retired, long& left, long& right) const {
+    STEP_ENGINE_ATOMIC() {
+        retired = retired_blocks;
+        left = left_position;
+        right = right_position;
+    }
+}
+
+void StepEngine::resetPositions() {
+    STEP_ENGINE_ATOMIC() {
+        left_position = 0;
+        right_position = 0;
+    }
+}
+
+void StepEngine::service() {
+#if !defined(__AVR__)
+    if (!initialized || timer_paused) return;
+    
+    unsigned long now_us = micros();
+    while (now_us - last_service_us >= STEP_ENGINE_TICK_US) {
+        last_service_us += STEP_ENGINE_TICK_US;
+        onTick();
+    }
+#endif
+}
+
+void StepEngine::onTick() {
+    if (!block_active && !loadNextBlock()) {
+        if (idle_hold_percent < 100) {
+            chopIdleHold();
+        }
+        return;  // Nothing scheduled
+    }
+    
+    countdown_us -= STEP_ENGINE_TICK_US;
+    if (countdown_us > 0) return;
+    
+    // One major step: the major axis always steps, the minor axis steps
+    // whenever its DDA accumulator wraps
+    int left_direction = stepAxis(left_axis, major_steps, left_position);
+    int right_direction = stepAxis(right_axis, major_steps, right_position);
+    
+    // Motors stepping on the same tick share one port write
+    StepperDriver::stepPair(*left_motor, left_direction, *right_motor, right_direction);
+    
+    // Retire the block after the last major step and chain straight into
+    // the next one, so the planner never sees a gap at a junction
+    if (--remaining == 0) {
+        queue_tail = (queue_tail + 1) & STEP_ENGINE_QUEUE_MASK;
+        retired_blocks++;
+        long carry_us = countdown_us;
+        block_active = false;
+        if (loadNextBlock()) {
+            countdown_us += carry_us;
+        }
+        return;
+    }
+    
+    // Carry the remainder so the average rate stays exact
+    step_index++;
+    countdown_us += nextInterval();
+}
+
+void StepEngine::handleTimerInterrupt() {
+    if (active_engine) {
+        active_engine->onTick();
+    }
+}
+
+// === PRIVATE METHODS ===
+
+bool StepEngine::loadNextBlock() {
+    if (queue_tail == queue_head) return false;
+    
+    // Moving again, so the coils need full current
+    if (idle_hold_percent < 100) {
+        idle_hold_percent = 100;
+        hold_coils_on = true;
+        coils_released = false;
+        left_motor->hold();
+        right_motor->hold();
+    }
+    
+    const StepBlock& block = blocks[queue_tail];
+    major_steps = block.major_steps;
+    remaining = major_steps;
+    step_index = 0;
+    loadAxis(left_axis, block.left_steps, major_steps);
+    loadAxis(right_axis, block.right_steps, major_steps);
+    
+    // First step is due one full interval after the block starts, so
+    // back-to-back blocks never produce a shortened step
+    interval_us = block.interval_us;
+    countdown_us = nextInterval();
+    
+    block_active = true;
+    return true;
+}
+
+void StepEngine::chopIdleHold() {
+    if (idle_hold_percent == 0) {
+        left_motor->release();
+        right_motor->release();
+        hold_coils_on = false;
+        pauseTimer();
+        return;
+    }
+    
+    // Pulse-density modulation: on for idle_hold_percent of the ticks,
+    // spread evenly so the coil inductance smooths the current
+    hold_accumulator += idle_hold_percent;
+    bool on = (hold_accumulator >= 100);
+    if (on) hold_accumulator -= 100;
+    
+    if (on != hold_coils_on) {
+        hold_coils_on = on;
+        if (on) {
+            left_motor->hold();
+            right_motor->hold();
+        } else {
+            left_motor->release();
+            right_motor->release();
+        }
+    }
+}
+
+void StepEngine::loadAxis(Axis& axis, long steps, unsigned long major) {
+    axis.direction = (steps >= 0) ? 1 : -1;
+    axis.delta = (steps >= 0) ? steps : -steps;
+    
+    // Start half way so minor steps are centred in their major-step spans
+    axis.error = major / 2;
+}
+
+int StepEngine::stepAxis(Axis& axis, unsigned long major, volatile long& position) {
+    axis.error -= axis.delta;
+    if (axis.error >= 0) return 0;
+    
+    axis.error += major;
+    position += axis.direction;
+    return axis.direction;
+}
+
+uint16_t StepEngine::nextInterval() const {
+    unsigned long to_end = remaining - 1;
+    const StepBlock& block = blocks[queue_tail];
+    
+    if (block.profile == PROFILE_TRAPEZOID) {
+        // Accelerate from the entry speed, decelerate toward the exit speed;
+        // the slower of the two wins (triangle if the block is short)
+        unsigned long accel_index = block.entry_index + step_index;
+        unsigned long decel_index = block.exit_index + to_end;
+        unsigned long ramp_index = (accel_index < decel_index) ? accel_index : decel_index;
+        
+        if (ramp_index >= block.cruise_index) return interval_us;
+        return ramp_table[ramp_index];
+    }
+    
+    // Distance to the nearer end of the block selects the ramp entry, so
+    // acceleration and deceleration mirror each other (triangle if short)
+    unsigned long ramp_index = (step_index < to_end) ? step_index : to_end;
+    
+    if (block.profile == PROFILE_SCURVE) {
+        if (ramp_index >= block.ramp_steps) return interval_us;
+        
+        // Locate the span holding this step; every span is a power of two long
+        uint8_t shift = block.knot_shift;
+        uint8_t sub = subKnots(shift);
+        uint8_t knot, span_shift;
+        uint16_t offset;
+        if (ramp_index >= (1UL << shift)) {
+            knot = sub + (ramp_index >> shift);
+            span_shift = shift;
+            offset = ramp_index & ((1U << shift) - 1);
+        } else if (ramp_index < ((1UL << shift) >> sub)) {
+            knot = 0;
+            span_shift = shift - sub;
+            offset = ramp_index;
+        } else {
+            span_shift = shift - 1;
+            while (ramp_index < (1UL << span_shift)) span_shift--;
+            knot = span_shift - (shift - sub) + 1;
+            offset = ramp_index - (1U << span_shift);
+        }
+        
+        // Cubic Hermite interpolation keeps the interval's slope continuous
+        // across knots, so acceleration has no steps and jerk stays bounded
+        long start = scurve_knots[knot];
+        long change = (long)scurve_knots[knot + 1] - start;
+        long tangent_start = knotTangent(scurve_knots, block, knot, span_shift);
+        long tangent_end = knotTangent(scurve_knots, block, knot + 1, span_shift);
+        long cubic = tangent_start + tangent_end - 2 * change;
+        long quadratic = 3 * change - 2 * tangent_start - tangent_end;
+        long value = ((cubic * offset) >> span_shift) + quadratic;
+        value = ((value * offset) >> span_shift) + tangent_start;
+        value = (value * offset) >> span_shift;
+        
+        // The cubic may dip just past the last knot; never outrun the cruise speed
+        value += start;
+        return (value < interval_us) ? interval_us : (uint16_t)value;
+    }
+    
+    return interval_us;
+}
+
+uint8_t StepEngine::rampIndexFor(uint16_t interval_us) const {
+    uint8_t index = 0;
+    while (index < ramp_length && ramp_table[index] > interval_us) {
+        index++;
+    }
+    return index;
+}
+
+uint8_t StepEngine::junctionIndex(const StepBlock& from, const StepBlock& to) const {
+    if (from.profile != PROFILE_TRAPEZOID || to.profile != PROFILE_TRAPEZOID) return 0;
+    
+    // Deflection between the blocks in wheel-velocity space: the largest
+    // change in either wheel's speed per unit of major-axis speed. 0 for
+    // collinear blocks, 2 when a wheel reverses at full speed.
+    float left_change = fabs((float)from.left_steps / from.major_steps - (float)to.left_steps / to.major_steps);
+    float right_change = fabs((float)from.right_steps / from.major_steps - (float)to.right_steps / to.major_steps);
+    float deflection = (left_change > right_change) ? left_change : right_change;
+    
+    // A wheel can jump by the ramp's start speed (set by acceleration_steps)
+    // without losing steps, so the junction speed is start_speed / deflection
+    if (deflection < 0.001f) return ramp_length;
+    float junction_interval = ramp_table[0] * deflection;
+    if (junction_interval >= ramp_table[0]) return 0;
+    
+    // Round down to the fastest ramp entry that is not faster than the junction
+    uint8_t index = rampIndexFor((uint16_t)junction_interval);
+    if (index < ramp_length && ramp_table[index] < junction_interval && index > 0) index--;
+    return index;
+}
+
+void StepEngine::replan() {
+    uint8_t entry[STEP_ENGINE_QUEUE_SIZE];
+    
+    for (;;) {
+        // Snapshot the executing block
+        uint8_t tail;
+        bool active;
+        unsigned long done_steps, left_steps;
+        STEP_ENGINE_ATOMIC() {
+            tail = queue_tail;
+            active = block_active;
+            done_steps = step_index;
+            left_steps = remaining;
+        }
+        
+        uint8_t first = active ? ((tail + 1) & STEP_ENGINE_QUEUE_MASK) : tail;
+        if (first == queue_head) return;  // Nothing pending
+        uint8_t last = (queue_head - 1) & STEP_ENGINE_QUEUE_MASK;
+        
+        // Fastest entry into the first pending block the executing block allows
+        unsigned long limit = 0;
+        if (active && blocks[tail].profile == PROFILE_TRAPEZOID) {
+            const StepBlock& current = blocks[tail];
+            unsigned long accel_index = current.entry_index + done_steps;
+            unsigned long decel_index = current.exit_index + left_steps - 1;
+            unsigned long speed_index = (accel_index < current.cruise_index) ? accel_index : current.cruise_index;
+            
+            limit = current.entry_index + current.major_steps;
+            if (limit > current.cruise_index) limit = current.cruise_index;
+            if (decel_index < speed_index && limit > current.exit_index) {
+                limit = current.exit_index;  // Already slowing down for its old exit
+            }
+        }
+        
+        // Backward pass: every block must be able to stop by the end of the queue
+        unsigned long next_entry = 0;
+        uint8_t i = last;
+        for (;;) {
+            const StepBlock& block = blocks[i];
+            unsigned long max_entry = block.junction_index;
+            if (max_entry > block.cruise_index) max_entry = block.cruise_index;
+            if (i == first) {
+                if (max_entry > limit) max_entry = limit;
+            } else {
+                uint8_t cruise_before = blocks[(i - 1) & STEP_ENGINE_QUEUE_MASK].cruise_index;
+                if (max_entry > cruise_before) max_entry = cruise_before;
+            }
+            
+            unsigned long reachable = next_entry + block.major_steps;
+            entry[i] = (uint8_t)((max_entry < reachable) ? max_entry : reachable);
+            next_entry = entry[i];
+            
+            if (i == first) break;
+            i = (i - 1) & STEP_ENGINE_QUEUE_MASK;
+        }
+        
+        // Forward pass: never enter faster than the previous block can accelerate to
+        for (i = first; i != last; i = (i + 1) & STEP_ENGINE_QUEUE_MASK) {
+            uint8_t next = (i + 1) & STEP_ENGINE_QUEUE_MASK;
+            unsigned long reachable = entry[i] + blocks[i].major_steps;
+            if (entry[next] > reachable) entry[next] = (uint8_t)reachable;
+        }
+        
+        // Commit unless the ISR moved on since the snapshot
+        bool committed = false;
+        STEP_ENGINE_ATOMIC() {
+            bool still_valid = (queue_tail == tail) && (block_active == active);
+            if (still_valid && active && entry[first] > blocks[tail].exit_index) {
+                // Raising the exit is only smooth while the block is not yet decelerating
+                const StepBlock& current = blocks[tail];
+                unsigned long accel_index = current.entry_index + step_index;
+                unsigned long decel_index = current.exit_index + remaining - 1;
+                unsigned long speed_index = (accel_index < current.cruise_index) ? accel_index : current.cruise_index;
+                still_valid = (decel_index >= speed_index);
+            }
+            
+            if (still_valid) {
+                if (active) blocks[tail].exit_index = entry[first];
+                for (i = first; ; i = (i + 1) & STEP_ENGINE_QUEUE_MASK) {
+                    blocks[i].entry_index = entry[i];
+                    blocks[i].exit_index = (i == last) ? 0 : entry[(i + 1) & STEP_ENGINE_QUEUE_MASK];
+                    if (i == last) break;
+                }
+                committed = true;
+            }
+        }
+        if (committed) return;
+    }
+}
+
+bool StepEngine::hasSCurveBlock() const {
+    // A stale tail only makes the answer conservative
+    for (uint8_t i = queue_tail; i != queue_head; i = (i + 1) & STEP_ENGINE_QUEUE_MASK) {
+        if (blocks[i].profile == PROFILE_SCURVE) return true;
+    }
+    return false;
+}
+
+void StepEngine::planSCurve(StepBlock& block, unsigned long major_steps) {
+    // Velocities in steps per second
+    float start_speed = 1000000.0f / ramp_table[0];
+    float cruise_speed = 1000000.0f / block.interval_us;
+    if (cruise_speed <= start_speed) {
+        block.profile = PROFILE_CONSTANT;
+        return;
+    }
+    
+    // Peak acceleration of a smoothstep ramp is 1.5x its average, so the
+    // average is scaled down to keep the peak at the trapezoid acceleration
+    float max_speed = 1000000.0f / ramp_min_interval_us;
+    float accel = (max_speed * max_speed) / (3.0f * ramp_steps_configured);
+    
+    // Ramp distance to cruise speed, limited to half the block
+    unsigned long ramp_steps = (unsigned long)((cruise_speed * cruise_speed - start_speed * start_speed) / (2.0f * accel));
+    if (ramp_steps > major_steps / 2) ramp_steps = major_steps / 2;
+    if (ramp_steps == 0) {
+        block.profile = PROFILE_CONSTANT;
+        return;
+    }
+    
+    // Space knots a power of two apart so the ISR can shift instead of divide,
+    // counting the extra knots inside the first span
+    uint8_t shift = 0;
+    while (((ramp_steps + (1UL << shift) - 1) >> shift) + subKnots(shift) > STEP_ENGINE_SCURVE_KNOTS) shift++;
+    unsigned long knots = (ramp_steps + (1UL << shift) - 1) >> shift;
+    if ((knots << shift) > major_steps / 2) knots = ramp_steps >> shift;
+    if (knots == 0) {
+        block.profile = PROFILE_CONSTANT;
+        return;
+    }
+    ramp_steps = knots << shift;
+    
+    // Peak speed actually reachable over the quantized ramp
+    float end_speed = sqrt(start_speed * start_speed + 2.0f * accel * ramp_steps);
+    if (end_speed > cruise_speed) end_speed = cruise_speed;
+    
+    // Speed follows v(u) = v0 + dv * (3u^2 - 2u^3) over normalized time u, so
+    // distance is p(u) = T * (v0*u + dv * (u^3 - u^4/2)). Each knot solves
+    // p(u) = distance with a few Newton steps from the previous knot.
+    float delta_speed = end_speed - start_speed;
+    float duration = 2.0f * ramp_steps / (start_speed + end_speed);
+    float u = 0.0f;
+    uint8_t last = subKnots(shift) + knots;
+    
+    scurve_knots[0] = (uint16_t)(1000000.0f / start_speed);
+    for (uint8_t k = 1; k <= last; k++) {
+        float distance = (float)knotPosition(shift, k);
+        for (uint8_t i = 0; i < 4; i++) {
+            float u2 = u * u;
+            float position = duration * (start_speed * u + delta_speed * (u2 * u - 0.5f * u2 * u2));
+            float speed = start_speed + delta_speed * (3.0f * u2 - 2.0f * u2 * u);
+            u += (distance - position) / (duration * speed);
+            if (u > 1.0f) u = 1.0f;
+        }
+        float u2 = u * u;
+        float speed = start_speed + delta_speed * (3.0f * u2 - 2.0f * u2 * u);
+        scurve_knots[k] = (uint16_t)(1000000.0f / speed);
+    }
+    
+    // Cruise at the ramp's end speed if the block is too short to reach full speed
+    if (scurve_knots[last] > block.interval_us) {
+        block.interval_us = scurve_knots[last];
+    }
+    
+    block.knot_shift = shift;
+    block.ramp_steps = (uint16_t)ramp_steps;
+}
+
+void StepEngine::startTimer() {
+#if defined(__AVR__)
+    STEP_ENGINE_ATOMIC() {
+        TCCR2A = _BV(WGM21);                     // CTC mode
+        TCCR2B = _BV(CS21);                      // Prescaler 8
+        OCR2A = (uint8_t)((F_CPU / 8000000UL) * STEP_ENGINE_TICK_US - 1);
+        TCNT2 = 0;
+        TIMSK2 |= _BV(OCIE2A);                   // Enable compare match A
+    }
+#else
+    last_service_us = micros();
+#endif
+    hold_tick = false;
+}
+
+void StepEngine::startHoldTimer() {
+#if defined(__AVR__)
+    STEP_ENGINE_ATOMIC() {
+        TCCR2B = _BV(CS22);                      // Prescaler 64
+        OCR2A = (uint8_t)((F_CPU / 64UL) * STEP_ENGINE_HOLD_TICK_US / 1000000UL - 1);
+        TCNT2 = 0;
+    }
+#endif
+    hold_tick = true;
+}
+
+void StepEngine::pauseTimer() {
+#if defined(__AVR__)
+    TIMSK2 &= ~_BV(OCIE2A);
+#endif
+    timer_paused = true;
+}
+
+#if defined(__AVR__)
+ISR(TIMER2_COMPA_vect) {
+    StepEngine::handleTimerInterrupt();
+}
+#endif
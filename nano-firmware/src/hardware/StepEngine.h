@@ -0,0 +1,384 @@
+#ifndef STEP_ENGINE_H
+#define STEP_ENGINE_H
+
+#include <Arduino.h>
+#include "StepperDriver.h"
+
+// === STEP ENGINE TIMING ===
+// Timer2 runs in CTC mode at a fixed tick; every step interval is rounded
+// to this resolution on average (jitter is at most one tick).
+#ifndef STEP_ENGINE_TICK_US
+#define STEP_ENGINE_TICK_US 50                   // 20 kHz step tick
+#endif
+
+// While the coils are chopped at reduced idle hold, Timer2 drops to a
+// slower prescale so it does not wake a sleeping MCU every step tick.
+#ifndef STEP_ENGINE_HOLD_TICK_US
+#define STEP_ENGINE_HOLD_TICK_US 500             // 2 kHz chop tick (at most 1024 at 16 MHz)
+#endif
+
+#ifndef STEP_ENGINE_QUEUE_SIZE
+#define STEP_ENGINE_QUEUE_SIZE 8                 // Must be a power of two (look-ahead depth)
+#endif
+
+#ifndef STEP_ENGINE_RAMP_MAX
+#define STEP_ENGINE_RAMP_MAX 64                  // Max acceleration table entries
+#endif
+
+#ifndef STEP_ENGINE_SCURVE_KNOTS
+#define STEP_ENGINE_SCURVE_KNOTS 8               // Interpolated segments per S-curve ramp (at least 4)
+#endif
+
+/**
+ * Velocity profile applied to each step block
+ */
+enum MotionProfile : uint8_t {
+    PROFILE_CONSTANT = 0,   // Every step at the cruise interval
+    PROFILE_TRAPEZOID = 1,  // Constant acceleration ramps (shared table)
+    PROFILE_SCURVE = 2      // Jerk-limited ramps (shared knot table)
+};
+
+/**
+ * Step block - one entry of the step schedule
+ *
+ * Holds the signed step count for each motor and the interval between
+ * steps of the major (larger) axis. The minor axis is interpolated with
+ * a DDA so both wheels start and finish the block together.
+ *
+ * Trapezoid blocks index the shared ramp table; the look-ahead planner
+ * sets entry/exit indices so consecutive blocks can run through their
+ * junction without stopping. An S-curve block's ramp is a few knots
+ * spaced 2^knot_shift steps apart, with extra knots inside the first span
+ * where the interval changes fastest; the ISR interpolates a cubic between
+ * them so acceleration stays continuous. The knots live in the engine's
+ * single knot table, so only one S-curve block is queued at a time.
+ */
+struct StepBlock {
+    long left_steps;             // Signed steps for left motor (+ = forward)
+    long right_steps;            // Signed steps for right motor (+ = forward)
+    uint16_t interval_us;        // Microseconds between major-axis steps
+    unsigned long major_steps;   // Steps of the larger axis
+    uint8_t profile;             // MotionProfile for this block
+    uint8_t cruise_index;        // First ramp index at or above cruise speed
+    uint8_t junction_index;      // Max entry ramp index from the previous block
+    uint8_t entry_index;         // Planned ramp index at block start
+    uint8_t exit_index;          // Planned ramp index at block end
+    uint8_t knot_shift;          // log2(steps between S-curve knots)
+    uint16_t ramp_steps;         // S-curve ramp length in steps
+};
+
+/**
+ * StepEngine - Interrupt-driven step generation for both drive motors
+ *
+ * Features:
+ * - Hardware timer ISR issues steps independent of loop() workload
+ * - Bresenham/DDA interpolation keeps both wheels in sync at any ratio
+ * - Trapezoidal acceleration ramps from a precomputed interval table
+ * - Look-ahead junction planning so chained blocks do not stop between them
+ *   (trapezoid blocks only)
+ * - Optional jerk-limited S-curve ramps precomputed per block; these start
+ *   and end at the ramp's start speed, so they slow at every junction, and
+ *   share one knot table, so the next is queued once the last has run
+ * - Small ring buffer so the next block can be queued while moving
+ * - Absolute step position counters maintained by the ISR
+ * - Reduced coil hold current while idle (chopped from the tick, or
+ *   released with the timer paused)
+ *
+ * Uses Timer2 on AVR (Timer0 drives millis(), Timer1 drives Servo), so
+ * tone() is unavailable while the engine is running. On other
+ * architectures call service() from the main loop instead.
+ *
+ * Usage:
+ *   StepEngine engine;
+ *   engine.begin(&left_motor, &right_motor);
+ *   engine.configureRamp(10000, 600, 50);  // Reach 600us after 50 steps
+ *   engine.queueBlock(200, 100, 1000);  // Left 200, right 100 steps, 1000us major interval
+ *
+ *   // Anywhere in the main loop:
+ *   if (engine.isIdle()) {
+ *     // All queued steps have been issued
+ *   }
+ */
+class StepEngine {
+private:
+    // Per-motor DDA state for the active block
+    struct Axis {
+        unsigned long delta;        // Absolute steps for this motor
+        long error;                 // DDA accumulator
+        int8_t direction;           // 1 forward, -1 backward
+    };
+    
+    // Hardware
+    StepperDriver* left_motor;
+    StepperDriver* right_motor;
+    
+    // Step schedule (written by main loop, drained by ISR)
+    StepBlock blocks[STEP_ENGINE_QUEUE_SIZE];
+    volatile uint8_t queue_head;    // Next free slot (main loop owns)
+    volatile uint8_t queue_tail;    // Oldest pending block (ISR owns)
+    
+    // Active block state (ISR owns)
+    Axis left_axis;
+    Axis right_axis;
+    unsigned long major_steps;      // Steps of the larger axis in the block
+    unsigned long remaining;        // Major-axis steps left in the block
+    unsigned long step_index;       // Major-axis steps issued in the block
+    uint16_t interval_us;           // Cruise interval between major-axis steps
+    long countdown_us;              // Time until the next major step is due
+    volatile bool block_active;
+    
+    // Acceleration ramp (interval for the n-th step from standstill)
+    uint16_t ramp_table[STEP_ENGINE_RAMP_MAX];
+    volatile uint8_t ramp_length;   // 0 = constant speed
+    uint16_t ramp_min_interval_us;  // Interval the configured acceleration aims for
+    uint16_t ramp_top_interval_us;  // Fastest interval the table reaches (block speed limit)
+    uint16_t ramp_steps_configured; // Requested trapezoid ramp length
+    uint16_t scurve_knots[STEP_ENGINE_SCURVE_KNOTS + 1]; // Intervals at each knot of the queued S-curve block
+    
+    // Absolute step positions (ISR writes, main loop reads atomically)
+    volatile long left_position;
+    volatile long right_position;
+    volatile uint8_t retired_blocks; // Blocks whose last step has been issued (wraps)
+    
+    // Idle coil hold (restored to full when the next block starts)
+    volatile uint8_t idle_hold_percent; // Coil duty while no block runs (100 = full)
+    uint8_t hold_accumulator;       // Pulse-density modulator for the hold duty
+    bool hold_coils_on;             // Coils energised in the current chop tick
+    volatile bool coils_released;   // Released by release(); no hold until the next block
+    volatile bool timer_paused;     // Tick stopped while coils are released
+    volatile bool hold_tick;        // Tick slowed to STEP_ENGINE_HOLD_TICK_US while chopping
+    
+    // Engine state
+    bool initialized;
+    unsigned long last_service_us;  // Software tick reference (non-AVR)
+    
+    // ISR dispatch target
+    static StepEngine* active_engine;
+
+public:
+    // === CONSTRUCTOR ===
+    
+    /**
+     * Default constructor
+     */
+    StepEngine();
+    
+    // === INITIALIZATION ===
+    
+    /**
+     * Attach motors and start the step timer
+     * @param left Left wheel driver (must already be initialized)
+     * @param right Right wheel driver (must already be initialized)
+     */
+    void begin(StepperDriver* left, StepperDriver* right);
+    
+    /**
+     * Build the acceleration ramp used at the start and end of every block
+     *
+     * Intervals follow a constant acceleration that reaches min_interval_us
+     * after ramp_steps steps. A ramp longer than STEP_ENGINE_RAMP_MAX keeps
+     * that acceleration but the table stops after STEP_ENGINE_RAMP_MAX
+     * entries, so ramped blocks top out at the last entry's speed instead.
+     * Call while the engine is idle.
+     * @param start_interval_us Slowest allowed interval (first step cap)
+     * @param min_interval_us Fastest interval the motors can sustain
+     * @param ramp_steps Steps to reach full speed (0 disables ramping)
+     */
+    void configureRamp(uint16_t start_interval_us, uint16_t min_interval_us, uint16_t ramp_steps);
+    
+    /**
+     * Get the number of acceleration steps in the active ramp
+     * @return Ramp length in steps (0 if ramping is disabled)
+     */
+    uint8_t getRampLength() const { return ramp_length; }
+    
+    // === SCHEDULING ===
+    
+    /**
+     * Append a block to the step schedule
+     * @param left_steps Signed step count for left motor
+     * @param right_steps Signed step count for right motor
+     * @param interval_us Cruise interval between steps of the larger axis
+     *                    (the ramp slows the first and last steps of the block)
+     * @param profile Velocity profile for the block
+     * @return true if queued, false if the schedule is full or (for an
+     *         S-curve block) another S-curve block still holds the knot table
+     */
+    bool queueBlock(long left_steps, long right_steps, uint16_t interval_us,
+                    MotionProfile profile = PROFILE_TRAPEZOID);
+    
+    /**
+     * Discard all pending and active blocks immediately
+     * Coils are left in their current state (caller decides hold/release)
+     */
+    void stop();
+    
+    /**
+     * Discard all blocks and release both coils
+     * The idle chop and the step tick stay off, and setIdleHold() leaves
+     * the coils released, until the next block is queued.
+     */
+    void release();
+    
+    /**
+     * Lower the coil hold current until the next block starts
+     * 100 holds at full current. 0 releases the coils and pauses the step
+     * timer so only UART and millis() interrupts wake the MCU. Anything in
+     * between switches the coils on for that share of ticks, with the tick
+     * slowed to STEP_ENGINE_HOLD_TICK_US. Full hold and the step tick
+     * return when the next block is queued.
+     * @param percent Hold current as % of full
+     */
+    void setIdleHold(uint8_t percent);
+    
+    // === STATE QUERIES ===
+    
+    /**
+     * Check if the schedule has been fully drained
+     * @return true if no block is active or pending
+     */
+    bool isIdle() const;
+    
+    /**
+     * Check if the schedule is ramping down to rest
+     * True while the last scheduled block is in its final deceleration
+     * (for constant-speed blocks, its last acceleration_steps steps), so
+     * callers can overlap work with the end of the motion.
+     * @return true if stopping or already idle
+     */
+    bool isStopping() const;
+    
+    /**
+     * Get the interval before the next major step
+     * Follows the ramp, so successive reads trace the velocity profile.
+     * @return Microseconds, or 0 if no block is active
+     */
+    uint16_t getStepInterval() const;
+    
+    /**
+     * Get number of free schedule slots
+     * @return Blocks that can be queued without blocking
+     */
+    uint8_t getFreeSlots() const;
+    
+    /**
+     * Get absolute left motor position (atomic read)
+     * @return Signed step count since last reset
+     */
+    long getLeftPosition() const;
+    
+    /**
+     * Get absolute right motor position (atomic read)
+     * @return Signed step count since last reset
+     */
+    long getRightPosition() const;
+    
+    /**
+     * Read the retired-block count and both positions in one atomic snapshot
+     * The count wraps and goes up by one as each block's last step is
+     * issued (not for blocks discarded by stop()), so callers can tell
+     * which queued block the positions are part way through.
+     */
+    void getProgress(uint8_t& retired, long& left, long& right) const;
+    
+    /**
+     * Reset both position counters to zero
+     */
+    void resetPositions();
+    
+    // === SOFTWARE TICK ===
+    
+    /**
+     * Run any ticks that are due (non-AVR builds only)
+     * No-op on AVR where Timer2 drives the engine.
+     */
+    void service();
+    
+    /**
+     * Timer tick handler - called from the ISR
+     */
+    void onTick();
+    
+    /**
+     * ISR trampoline to the attached engine
+     */
+    static void handleTimerInterrupt();
+
+private:
+    // === INTERNAL HELPERS ===
+    
+    /**
+     * Load the oldest pending block and initialise the DDA
+     * @return true if a block was loaded
+     */
+    bool loadNextBlock();
+    
+    /**
+     * Prepare one axis of the DDA for a new block
+     */
+    static void loadAxis(Axis& axis, long steps, unsigned long major);
+    
+    /**
+     * Advance one axis by one major step
+     * @return Direction of the step that is due (1/-1), or 0 if none
+     */
+    static int stepAxis(Axis& axis, unsigned long major, volatile long& position);
+    
+    /**
+     * Apply the idle hold duty for one tick (ISR, no block active)
+     */
+    void chopIdleHold();
+    
+    /**
+     * Interval before the next major step, including ramp up/down
+     */
+    uint16_t nextInterval() const;
+    
+    /**
+     * First ramp index whose interval is at or below the given interval
+     * @return Ramp index, or the ramp length if the ramp never gets that fast
+     */
+    uint8_t rampIndexFor(uint16_t interval_us) const;
+    
+    /**
+     * Maximum ramp index at which 'to' may start after 'from'
+     * 0 unless both are trapezoid blocks: an S-curve block's knots are fixed
+     * when it is queued, so it cannot take a planned entry or exit speed.
+     */
+    uint8_t junctionIndex(const StepBlock& from, const StepBlock& to) const;
+    
+    /**
+     * Recompute entry/exit speeds of pending blocks (backward/forward pass)
+     */
+    void replan();
+    
+    /**
+     * Check if an active or pending block uses the S-curve knot table
+     */
+    bool hasSCurveBlock() const;
+    
+    /**
+     * Precompute the S-curve knot table for a block (main loop only, while
+     * no other S-curve block is queued)
+     * @param block Block with steps and cruise interval already set
+     * @param major_steps Steps of the larger axis
+     */
+    void planSCurve(StepBlock& block, unsigned long major_steps);
+    
+    /**
+     * Configure Timer2 for the fixed engine tick
+     */
+    void startTimer();
+    
+    /**
+     * Slow the running tick to STEP_ENGINE_HOLD_TICK_US for idle chopping
+     */
+    void startHoldTimer();
+    
+    /**
+     * Stop the tick interrupt until startTimer() (ISR or atomic block)
+     */
+    void pauseTimer();
+};
+
+#endif // STEP_ENGINE_H
@@ -1,5 +1,9 @@
 #include "StepperDriver.h"
 
+#if STEPPER_FAST_IO
+#include <util/atomic.h>
+#endif
+
 // 28BYJ-48 half-step sequence for smooth operation
 // Phase sequence: [IN1, IN2, IN3, IN4]
 const int StepperDriver::PHASE_SEQUENCE[8][4] = {
@@ -19,6 +23,9 @@ StepperDriver::StepperDriver() :
     step_interval_us(10000),  // Default: 100 steps/sec
     initialized(false),
     motor_enabled(false)
+#if STEPPER_FAST_IO
+    , port_count(0)
+#endif
 {
     // Initialize pin array
     for (int i = 0; i < 4; i++) {
@@ -39,6 +46,11 @@ void StepperDriver::begin(int in1, int in2, int in3, int in4) {
         digitalWrite(pins[i], LOW);
     }
     
+#if STEPPER_FAST_IO
+    // Resolve pins to port registers once so each step is a single write
+    resolvePorts();
+#endif
+    
     // Initialize state
     current_phase = 0;
     last_step_us = micros();
@@ -112,6 +124,52 @@ void StepperDriver::stepNow(int direction) {
     last_step_us = micros();
 }
 
+void StepperDriver::stepPair(StepperDriver& a, int direction_a, StepperDriver& b, int direction_b) {
+    if (!a.initialized || !b.initialized) return;
+    
+    if (direction_a != 0) {
+        a.updatePhase(direction_a);
+        a.motor_enabled = true;
+    }
+    if (direction_b != 0) {
+        b.updatePhase(direction_b);
+        b.motor_enabled = true;
+    }
+    
+#if STEPPER_FAST_IO
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint8_t merged = 0;  // Bit j set once b.ports[j] has been written
+        
+        // Write each of a's ports, folding in b's coils on the same port
+        for (uint8_t i = 0; i < a.port_count; i++) {
+            const CoilPort& port = a.ports[i];
+            uint8_t mask = port.mask;
+            uint8_t bits = a.activeBits(i);
+            
+            for (uint8_t j = 0; j < b.port_count; j++) {
+                if (b.ports[j].reg == port.reg) {
+                    mask |= b.ports[j].mask;
+                    bits |= b.activeBits(j);
+                    merged |= (1 << j);
+                }
+            }
+            *port.reg = (*port.reg & ~mask) | bits;
+        }
+        
+        // Remaining ports used only by b
+        for (uint8_t j = 0; j < b.port_count; j++) {
+            if (!(merged & (1 << j))) {
+                const CoilPort& port = b.ports[j];
+                *port.reg = (*port.reg & ~port.mask) | b.activeBits(j);
+            }
+        }
+    }
+#else
+    a.applyPhase();
+    b.applyPhase();
+#endif
+}
+
 bool StepperDriver::isReady() const {
     if (!initialized) return false;
     
@@ -161,9 +219,7 @@ void StepperDriver::applyPhase() {
     }
     
     // Apply current phase to pins
-    for (int i = 0; i < 4; i++) {
-        digitalWrite(pins[i], PHASE_SEQUENCE[current_phase][i]);
-    }
+    writeCoils(current_phase);
 }
 
 void StepperDriver::updatePhase(int direction) {
@@ -180,7 +236,61 @@ void StepperDriver::updatePhase(int direction) {
 void StepperDriver::clearPins() {
     if (!initialized) return;
     
+    writeCoils(-1);
+}
+
+void StepperDriver::writeCoils(int phase) {
+#if STEPPER_FAST_IO
+    // One read-modify-write per port; atomic because other pins on the
+    // same port (e.g. servo on PORTB) may be written from interrupts
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (uint8_t i = 0; i < port_count; i++) {
+            CoilPort& port = ports[i];
+            uint8_t bits = (phase >= 0) ? port.phase_bits[phase] : 0;
+            *port.reg = (*port.reg & ~port.mask) | bits;
+        }
+    }
+#else
     for (int i = 0; i < 4; i++) {
-        digitalWrite(pins[i], LOW);
+        digitalWrite(pins[i], (phase >= 0) ? PHASE_SEQUENCE[phase][i] : LOW);
     }
-}
\ No newline at end of file
+#endif
+}
+
+#if STEPPER_FAST_IO
+void StepperDriver::resolvePorts() {
+    port_count = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        volatile uint8_t* reg = portOutputRegister(digitalPinToPort(pins[i]));
+        uint8_t bit = digitalPinToBitMask(pins[i]);
+        
+        // Find existing slot for this port or add a new one
+        uint8_t slot = 0;
+        while (slot < port_count && ports[slot].reg != reg) {
+            slot++;
+        }
+        if (slot == port_count) {
+            if (port_count >= STEPPER_MAX_PORTS) continue;  // Not possible on ATmega328
+            ports[slot].reg = reg;
+            ports[slot].mask = 0;
+            for (int phase = 0; phase < 8; phase++) {
+                ports[slot].phase_bits[phase] = 0;
+            }
+            port_count++;
+        }
+        
+        // Precompute this coil's bit for every phase
+        ports[slot].mask |= bit;
+        for (int phase = 0; phase < 8; phase++) {
+            if (PHASE_SEQUENCE[phase][i]) {
+                ports[slot].phase_bits[phase] |= bit;
+            }
+        }
+    }
+}
+
+uint8_t StepperDriver::activeBits(uint8_t port_index) const {
+    return motor_enabled ? ports[port_index].phase_bits[current_phase] : 0;
+}
+#endif
\ No newline at end of file
@@ -3,6 +3,16 @@
 
 #include <Arduino.h>
 
+// Direct port-register coil output (AVR only, digitalWrite() elsewhere)
+#if defined(__AVR__)
+#define STEPPER_FAST_IO 1
+#else
+#define STEPPER_FAST_IO 0
+#endif
+
+// Coil pins of one motor can span at most three ports on the ATmega328
+#define STEPPER_MAX_PORTS 3
+
 /**
  * StepperDriver - Controls 28BYJ-48 stepper motors via ULN2803A driver
  * 
@@ -11,6 +21,7 @@
  * - Non-blocking stepping with precise timing control
  * - Configurable speed control
  * - Motor hold/release for power management
+ * - Single masked port write per coil pattern (pins resolved once in begin())
  * 
  * Usage:
  *   StepperDriver motor;
@@ -40,6 +51,17 @@ private:
     bool initialized;
     bool motor_enabled;
     
+#if STEPPER_FAST_IO
+    // Fast output path - coil pins grouped by output port
+    struct CoilPort {
+        volatile uint8_t* reg;      // PORTx output register
+        uint8_t mask;               // All coil bits driven on this port
+        uint8_t phase_bits[8];      // Coil bits set for each phase
+    };
+    CoilPort ports[STEPPER_MAX_PORTS];
+    uint8_t port_count;
+#endif
+
 public:
     // === CONSTRUCTOR ===
     
@@ -93,6 +115,18 @@ public:
      */
     void stepNow(int direction);
     
+    /**
+     * Step two motors at once (used by the step engine ISR)
+     * Coil bits that share an output port are updated with one write,
+     * e.g. pins 2-7 (PORTD) for both motors with the default wiring.
+     * Does not update the isReady() timestamp.
+     * @param a First motor
+     * @param direction_a 1 forward, -1 backward, 0 no step
+     * @param b Second motor
+     * @param direction_b 1 forward, -1 backward, 0 no step
+     */
+    static void stepPair(StepperDriver& a, int direction_a, StepperDriver& b, int direction_b);
+    
     /**
      * Check if ready for next step
      * @return true if enough time has passed for next step
@@ -151,6 +185,25 @@ private:
      * Set all motor pins to OFF state
      */
     void clearPins();
+    
+    /**
+     * Write coil pattern for a phase (all coils off if phase < 0)
+     * @param phase Phase index 0-7, or -1 for all off
+     */
+    void writeCoils(int phase);
+    
+#if STEPPER_FAST_IO
+    /**
+     * Resolve coil pins to port register/bitmask pairs
+     */
+    void resolvePorts();
+    
+    /**
+     * Get coil bits currently driven on one of this motor's ports
+     * @param port_index Index into ports[]
+     */
+    uint8_t activeBits(uint8_t port_index) const;
+#endif
 };
 
 #endif // STEPPER_DRIVER_H
\ No newline at end of file
@@ -12,22 +12,41 @@
 #include "robot/TerraPenRobot.h"
 #include "ErrorSystem.h"
 #include "PerformanceMonitor.h"
+#include "TaskScheduler.h"
+#include "PowerManager.h"
+#include "communication/BinaryProtocol.h"
+#include "communication/CommandReader.h"
+#include "communication/JsonArena.h"
 #include <ArduinoJson.h>
 
 // Hardware configuration
 TerraPenRobot robot;
-PerformanceMonitor perf_monitor;
+TaskScheduler scheduler;
+PowerManager power_manager;
 
-// Communication state
-String inputBuffer = "";
-unsigned long lastStatusUpdate = 0;
-const unsigned long STATUS_UPDATE_INTERVAL = 1000; // 1 second
+// Communication state (static buffers; commands and replies never touch the heap)
+CommandReader reader;
+JsonArena jsonArena;             // Memory for every JsonDocument below
+bool binaryReplies = false;      // Last command was framed; answer and report in kind
+
+// Task timing (period, then latest finish after becoming runnable, see TaskScheduler)
+const unsigned long MOTION_DEADLINE_US = 5000;         // Every pass; refill well inside one block
+const unsigned long COMMAND_PERIOD_US = 2000;          // RX buffer fills in ~11 ms at 57600 baud
+const unsigned long COMMAND_DEADLINE_US = 10000;
+const unsigned long STATUS_UPDATE_INTERVAL_US = 1000000; // 1 second
+const unsigned long STATUS_DEADLINE_US = 50000;
+const unsigned long POWER_PERIOD_US = 100000;          // Coil timeout resolution
+const unsigned long POWER_DEADLINE_US = 70000;         // Runs last: every other deadline plus its own run
 
 // Function declarations
+void motionTask();
+void powerTask();
 void handleSerialCommands();
-void processCommand(const String& command);
+void processCommand(char* line, uint8_t length);
+void processFrame(uint8_t* frame, uint8_t length);
+void sendBinaryResult(uint8_t opcode, bool ok, ErrorCode error);
 void sendAck();
-void sendError(const String& errorMsg);
+void sendError(const char* errorMsg);
 void sendPositionUpdate();
 void sendStatusUpdate();
 
@@ -42,53 +61,78 @@ void setup() {
     robot.begin();
     Serial.println("✓ Robot initialized successfully");
     
-    // Initialize performance monitor
-    // perf_monitor will auto-initialize on first call
+    // Coil hold current drops after motor_sleep_timeout_ms at rest
+    power_manager.begin(&robot);
+    
+    // Overruns go to g_performance_monitor; NVRAM and upload tasks join at
+    // TASK_PRIORITY_BACKGROUND once those subsystems run from main
+    scheduler.addTask(motionTask, 0, MOTION_DEADLINE_US, TASK_PRIORITY_MOTION);
+    scheduler.addTask(handleSerialCommands, COMMAND_PERIOD_US, COMMAND_DEADLINE_US, TASK_PRIORITY_COMMAND);
+    scheduler.addTask(sendStatusUpdate, STATUS_UPDATE_INTERVAL_US, STATUS_DEADLINE_US, TASK_PRIORITY_TELEMETRY);
+    scheduler.addTask(powerTask, POWER_PERIOD_US, POWER_DEADLINE_US, TASK_PRIORITY_BACKGROUND);
     
     Serial.println("TerraPen Nano Ready - Waiting for commands");
     sendStatusUpdate();
 }
 
 void loop() {
+    // Every due task once, highest priority first; no fixed sleep
+    scheduler.run();
+    
+    // Stopped: doze until the next UART byte or timer tick
+    power_manager.sleep();
+}
+
+void motionTask() {
     // Update robot state machine
     robot.update();
-    
-    // Handle serial communication
-    handleSerialCommands();
-    
-    // Send periodic status updates
-    if (millis() - lastStatusUpdate >= STATUS_UPDATE_INTERVAL) {
-        sendStatusUpdate();
-        lastStatusUpdate = millis();
-    }
-    
-    // Update performance monitoring
-    // perf_monitor.update(); // TODO: Check API
-    
-    // Small delay to prevent overwhelming the serial buffer
-    delay(10);
+}
+
+void powerTask() {
+    power_manager.update();
 }
 
 void handleSerialCommands() {
-    while (Serial.available()) {
-        char c = Serial.read();
-        
-        if (c == '\n' || c == '\r') {
-            if (inputBuffer.length() > 0) {
-                processCommand(inputBuffer);
-                inputBuffer = "";
-            }
-        } else {
-            inputBuffer += c;
+    // Each message is handled before the reader takes the next one, so
+    // the views into its buffer stay valid for the whole command
+    CommandReaderResult result;
+    while ((result = reader.read(Serial)) != READ_PENDING) {
+        switch (result) {
+            case READ_LINE:
+                processCommand(reader.line(), reader.size());
+                break;
+            
+            case READ_FRAME:
+                processFrame(reader.frame(), reader.size());
+                break;
+            
+            case READ_LINE_OVERFLOW:
+                binaryReplies = false;
+                sendError("Command line too long");
+                break;
+            
+            case READ_FRAME_OVERFLOW:
+                binaryReplies = true;
+                sendBinaryResult(0, false, ERR_INVALID_COMMAND);
+                break;
+            
+            default:
+                break;
         }
     }
 }
 
-void processCommand(const String& command) {
-    // Parse JSON command
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, command);
+void processCommand(char* line, uint8_t length) {
+    binaryReplies = false;
     
+    // Parse JSON command straight from the reader's buffer
+    JsonDocument doc(&jsonArena);
+    DeserializationError error = deserializeJson(doc, line, length);
+    
+    if (error == DeserializationError::NoMemory) {
+        sendError("JSON command too large");
+        return;
+    }
     if (error) {
         sendError("Invalid JSON command");
         return;
@@ -106,13 +150,10 @@ void processCommand(const String& command) {
             if (doc["x"].is<float>() && doc["y"].is<float>()) {
                 float x = doc["x"];
                 float y = doc["y"];
-                bool penDown = doc["pen_down"].is<bool>() ? doc["pen_down"].as<bool>() : false;
-                
-                if (!penDown) {
-                    robot.penUp(); // Pen up for movement
-                }
+                float speed = doc["speed"] | g_config.getCruiseSpeedMms();
                 
-                if (robot.moveTo(x, y)) {
+                // Travel moves raise the pen when they start; queued behind active motion
+                if (robot.moveTo(x, y, speed)) {
                     sendAck();
                 } else {
                     sendError("Move command failed");
@@ -121,13 +162,14 @@ void processCommand(const String& command) {
                 sendError("MOVE_TO requires x,y coordinates");
             }
             break;
-            
+        
         case 2: // DRAW_TO
             if (doc["x"].is<float>() && doc["y"].is<float>()) {
                 float x = doc["x"];
                 float y = doc["y"];
+                float speed = doc["speed"] | g_config.getCruiseSpeedMms();
                 
-                if (robot.drawTo(x, y)) {
+                if (robot.drawTo(x, y, speed)) {
                     sendAck();
                 } else {
                     sendError("Draw command failed");
@@ -136,7 +178,7 @@ void processCommand(const String& command) {
                 sendError("DRAW_TO requires x,y coordinates");
             }
             break;
-            
+        
         case 3: // SET_PEN
             if (doc["down"].is<bool>()) {
                 bool down = doc["down"];
@@ -150,11 +192,11 @@ void processCommand(const String& command) {
                 sendError("SET_PEN requires 'down' parameter");
             }
             break;
-            
+        
         case 4: // GET_POSITION
             sendPositionUpdate();
             break;
-            
+        
         case 5: // HOME
             // HOME command - move to origin
             if (robot.moveTo(0, 0)) {
@@ -163,65 +205,269 @@ void processCommand(const String& command) {
                 sendError("Home command failed");
             }
             break;
-            
+        
         case 6: // EMERGENCY_STOP
             robot.emergencyStop();
             sendAck();
             break;
-            
+        
         case 7: // GET_STATUS
             sendStatusUpdate();
             break;
-            
+        
         case 8: // CALIBRATE
             // TODO: Implement calibration routine
             sendError("Calibration not yet implemented");
             break;
+        
+        case 9: // SET_ROBOT_PARAMETERS
+            if (doc["wheel_diameter"].is<float>() || doc["left_diameter"].is<float>() ||
+                doc["right_diameter"].is<float>() || doc["wheelbase"].is<float>()) {
+                // Unspecified values keep the current calibration
+                const KinematicModel& model = robot.getKinematics();
+                float left_diameter = model.getLeftDiameter();
+                float right_diameter = model.getRightDiameter();
+                float wheelbase = model.getWheelbase();
+                
+                if (doc["wheel_diameter"].is<float>()) {
+                    left_diameter = doc["wheel_diameter"];
+                    right_diameter = left_diameter;
+                }
+                if (doc["left_diameter"].is<float>()) left_diameter = doc["left_diameter"];
+                if (doc["right_diameter"].is<float>()) right_diameter = doc["right_diameter"];
+                if (doc["wheelbase"].is<float>()) wheelbase = doc["wheelbase"];
+                
+                if (robot.setGeometry(left_diameter, right_diameter, wheelbase)) {
+                    sendAck();
+                } else {
+                    sendError("Parameters rejected (robot moving or invalid values)");
+                }
+            } else {
+                sendError("SET_ROBOT_PARAMETERS requires wheel_diameter, left_diameter, right_diameter or wheelbase");
+            }
+            break;
+        
+        case 11: // ARC_TO
+            if (doc["cx"].is<float>() && doc["cy"].is<float>() &&
+                doc["x"].is<float>() && doc["y"].is<float>()) {
+                // Ending on the current point draws a full circle
+                bool clockwise = doc["cw"] | true;
+                float speed = doc["speed"] | g_config.getCruiseSpeedMms();
+                
+                if (robot.arcTo(doc["cx"], doc["cy"], doc["x"], doc["y"], clockwise, speed)) {
+                    sendAck();
+                } else {
+                    sendError("Arc command failed");
+                }
+            } else {
+                sendError("ARC_TO requires cx,cy,x,y coordinates");
+            }
+            break;
+        
+        case 12: // SET_PATH_MODE
+            if (doc["tracking"].is<bool>() || doc["reverse"].is<int>()) {
+                // Applies to segments queued after this one is acknowledged
+                if (doc["tracking"].is<bool>()) {
+                    robot.setPathMode(doc["tracking"] ? PATH_TRACKING : PATH_SPOT_TURN);
+                }
+                if (doc["reverse"].is<int>()) {
+                    robot.setReverseMode((ReverseMode)constrain((int)doc["reverse"], 0, 2));
+                }
+                sendAck();
+            } else {
+                sendError("SET_PATH_MODE requires 'tracking' or 'reverse' parameter");
+            }
+            break;
+        
+        case 13: // CURVE_TO
+            if (doc["c1x"].is<float>() && doc["c1y"].is<float>() &&
+                doc["c2x"].is<float>() && doc["c2y"].is<float>() &&
+                doc["x"].is<float>() && doc["y"].is<float>()) {
+                // Flattened on the robot, so one command replaces a run of DRAW_TOs
+                float speed = doc["speed"] | g_config.getCruiseSpeedMms();
+                
+                if (robot.curveTo(doc["c1x"], doc["c1y"], doc["c2x"], doc["c2y"], doc["x"], doc["y"], speed)) {
+                    sendAck();
+                } else {
+                    sendError("Curve command failed");
+                }
+            } else {
+                sendError("CURVE_TO requires c1x,c1y,c2x,c2y,x,y coordinates");
+            }
+            break;
+        
+        default: {
+            // Built on the stack; itoa keeps printf out of the image
+            char message[32] = "Unknown command ID: ";
+            itoa(cmdId, message + strlen(message), 10);
+            sendError(message);
+            break;
+        }
+    }
+}
+
+void processFrame(uint8_t* frame, uint8_t length) {
+    binaryReplies = true;
+    
+    if (!unpackFrame(frame, length)) {
+        sendBinaryResult(0, false, ERR_CHECKSUM_FAILED);
+        return;
+    }
+    
+    // Payloads are fixed-size (plus optional trailing fields), read straight from the frame
+    uint8_t opcode = frame[0];
+    const uint8_t* payload = frame + 1;
+    uint8_t payload_length = length - 1;
+    if (!binaryPayloadValid(opcode, payload_length)) {
+        sendBinaryResult(opcode, false, ERR_INVALID_COMMAND);
+        return;
+    }
+    
+    switch (opcode) {
+        case BIN_MOVE_TO:
+        case BIN_DRAW_TO: {
+            float x = binaryToMm(readInt16LE(payload));
+            float y = binaryToMm(readInt16LE(payload + 2));
+            float speed = (payload_length > 4) ? binaryToSpeed(readUint16LE(payload + 4)) : g_config.getCruiseSpeedMms();
+            bool ok = (opcode == BIN_MOVE_TO) ? robot.moveTo(x, y, speed) : robot.drawTo(x, y, speed);
+            sendBinaryResult(opcode, ok, ERR_MOVEMENT_BLOCKED);
+            break;
+        }
+        
+        case BIN_SET_PEN:
+            if (payload[0]) {
+                robot.penDown();
+            } else {
+                robot.penUp();
+            }
+            sendBinaryResult(opcode, true, ERR_NONE);
+            break;
+        
+        case BIN_GET_POSITION:
+            sendPositionUpdate();
+            break;
+        
+        case BIN_HOME:
+            sendBinaryResult(opcode, robot.moveTo(0, 0), ERR_MOVEMENT_BLOCKED);
+            break;
+        
+        case BIN_EMERGENCY_STOP:
+            robot.emergencyStop();
+            sendBinaryResult(opcode, true, ERR_NONE);
+            break;
+        
+        case BIN_GET_STATUS:
+            sendStatusUpdate();
+            break;
+        
+        case BIN_SET_ROBOT_PARAMETERS: {
+            // Fields not flagged keep the current calibration
+            uint8_t fields = payload[0];
+            const KinematicModel& model = robot.getKinematics();
+            float left_diameter = (fields & 0x01) ? readFloatLE(payload + 1) : model.getLeftDiameter();
+            float right_diameter = (fields & 0x02) ? readFloatLE(payload + 5) : model.getRightDiameter();
+            float wheelbase = (fields & 0x04) ? readFloatLE(payload + 9) : model.getWheelbase();
             
-        default:
-            sendError("Unknown command ID: " + String(cmdId));
+            bool ok = (fields & 0x07) && robot.setGeometry(left_diameter, right_diameter, wheelbase);
+            sendBinaryResult(opcode, ok, ERR_INVALID_CONFIG);
+            break;
+        }
+        
+        case BIN_ARC_TO: {
+            float speed = (payload_length > 9) ? binaryToSpeed(readUint16LE(payload + 9)) : g_config.getCruiseSpeedMms();
+            sendBinaryResult(opcode, robot.arcTo(binaryToMm(readInt16LE(payload)), binaryToMm(readInt16LE(payload + 2)),
+                                                 binaryToMm(readInt16LE(payload + 4)), binaryToMm(readInt16LE(payload + 6)),
+                                                 payload[8] != 0, speed), ERR_MOVEMENT_BLOCKED);
+            break;
+        }
+        
+        case BIN_SET_PATH_MODE: {
+            uint8_t fields = payload[0];
+            if (fields & 0x01) {
+                robot.setPathMode(payload[1] ? PATH_TRACKING : PATH_SPOT_TURN);
+            }
+            if (fields & 0x02) {
+                robot.setReverseMode((ReverseMode)constrain(payload[2], 0, 2));
+            }
+            sendBinaryResult(opcode, (fields & 0x03) != 0, ERR_INVALID_COMMAND);
+            break;
+        }
+        
+        case BIN_CURVE_TO: {
+            float speed = (payload_length > 12) ? binaryToSpeed(readUint16LE(payload + 12)) : g_config.getCruiseSpeedMms();
+            sendBinaryResult(opcode, robot.curveTo(binaryToMm(readInt16LE(payload)), binaryToMm(readInt16LE(payload + 2)),
+                                                   binaryToMm(readInt16LE(payload + 4)), binaryToMm(readInt16LE(payload + 6)),
+                                                   binaryToMm(readInt16LE(payload + 8)), binaryToMm(readInt16LE(payload + 10)),
+                                                   speed),
+                             ERR_MOVEMENT_BLOCKED);
             break;
+        }
     }
 }
 
+void sendBinaryResult(uint8_t opcode, bool ok, ErrorCode error) {
+    uint8_t message[3] = {(uint8_t)(ok ? BIN_ACK : BIN_NACK), opcode, (uint8_t)error};
+    sendFrame(Serial, message, ok ? 2 : 3);
+}
+
 void sendAck() {
-    JsonDocument doc;
+    JsonDocument doc(&jsonArena);
     doc["response"] = 128; // ACK
     doc["timestamp"] = millis();
     
-    String response;
-    serializeJson(doc, response);
-    Serial.println(response);
+    serializeJson(doc, Serial);
+    Serial.println();
 }
 
-void sendError(const String& errorMsg) {
-    JsonDocument doc;
+void sendError(const char* errorMsg) {
+    JsonDocument doc(&jsonArena);
     doc["response"] = 129; // NACK
     doc["error_message"] = errorMsg;
     doc["timestamp"] = millis();
     
-    String response;
-    serializeJson(doc, response);
-    Serial.println(response);
+    serializeJson(doc, Serial);
+    Serial.println();
 }
 
 void sendPositionUpdate() {
     Position pos = robot.getCurrentPosition();
     
-    JsonDocument doc;
+    if (binaryReplies) {
+        uint8_t message[11];
+        message[0] = BIN_POSITION;
+        writeInt16LE(message + 1, mmToBinary(pos.x));
+        writeInt16LE(message + 3, mmToBinary(pos.y));
+        writeInt16LE(message + 5, radiansToBinary(pos.angle));
+        writeUint32LE(message + 7, millis());
+        sendFrame(Serial, message, sizeof(message));
+        return;
+    }
+    
+    JsonDocument doc(&jsonArena);
     doc["response"] = 130; // POSITION
     doc["position"]["x"] = pos.x;
     doc["position"]["y"] = pos.y;
     doc["position"]["angle"] = pos.angle;
     doc["timestamp"] = millis();
     
-    String response;
-    serializeJson(doc, response);
-    Serial.println(response);
+    serializeJson(doc, Serial);
+    Serial.println();
 }
 
 void sendStatusUpdate() {
-    JsonDocument doc;
+    if (binaryReplies) {
+        uint8_t message[10];
+        message[0] = BIN_STATUS;
+        message[1] = (uint8_t)robot.getState();  // Same numbering as the JSON state field
+        message[2] = robot.isPenDown() ? 1 : 0;
+        message[3] = robot.getFreeSlots();
+        writeUint16LE(message + 4, (uint16_t)g_performance_monitor.getMetrics().task_overruns);
+        writeUint32LE(message + 6, millis());
+        sendFrame(Serial, message, sizeof(message));
+        return;
+    }
+    
+    JsonDocument doc(&jsonArena);
     doc["response"] = 131; // STATUS
     
     // Robot state
@@ -241,14 +487,12 @@ void sendStatusUpdate() {
     }
     
     doc["pen_down"] = robot.isPenDown();
+    doc["queue_free"] = robot.getFreeSlots();
+    doc["overruns"] = g_performance_monitor.getMetrics().task_overruns;
     doc["timestamp"] = millis();
     
-    // Add basic system info
-    // TODO: Add performance data when API is available
-    
-    String response;
-    serializeJson(doc, response);
-    Serial.println(response);
+    serializeJson(doc, Serial);
+    Serial.println();
 }
 
 #endif // MATH_VALIDATION_MODE
\ No newline at end of file
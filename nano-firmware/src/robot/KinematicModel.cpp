@@ -0,0 +1,190 @@
+#include "KinematicModel.h"
+
+/**
+ * (value * constant) >> 16 from four 16x16-bit partial products
+ * The partial products are all non-negative and sum to the result, so no
+ * intermediate overflows as long as the result fits (|result| < 2^31).
+ * Truncates toward zero.
+ */
+static int32_t multiplyFixed(int32_t value, uint32_t constant) {
+    bool negative = (value < 0);
+    uint32_t magnitude = negative ? -(uint32_t)value : (uint32_t)value;
+    uint32_t value_high = magnitude >> 16;
+    uint32_t value_low = magnitude & 0xFFFF;
+    uint32_t constant_high = constant >> 16;
+    uint32_t constant_low = constant & 0xFFFF;
+    
+    uint32_t product = ((value_high * constant_high) << 16) + value_high * constant_low +
+                       value_low * constant_high + ((value_low * constant_low) >> 16);
+    return negative ? -(int32_t)product : (int32_t)product;
+}
+
+/**
+ * Round Q16.16 wheel steps to the nearest integer, halves away from zero
+ */
+static int roundSteps(fixed_t value) {
+    const fixed_t half = FIXED_ONE / 2;
+    if (value < 0) {
+        return -(int)((-value + half) >> FIXED_SHIFT);
+    }
+    return (int)((value + half) >> FIXED_SHIFT);
+}
+
+/**
+ * Round Q16.16 wheel steps plus a carried fraction, keeping the new fraction
+ * Rounds halves up so the fraction always fits [-0.5, 0.5) of a step.
+ */
+static int roundCarry(fixed_t value, int32_t& remainder) {
+    value += remainder;
+    fixed_t steps = (value + FIXED_ONE / 2) >> FIXED_SHIFT;
+    remainder = value - (steps << FIXED_SHIFT);
+    return (int)steps;
+}
+
+/**
+ * steps * per_step for a Q24.8 constant, split so nothing needs 64 bits
+ * Whole binary-angle units wrap modulo one turn in 32 bits; the fraction
+ * bits apply to steps / 256 and steps % 256 separately.
+ * @param fraction Receives the 8 fraction bits of the product
+ */
+static bam_t turnProduct(long steps, int32_t per_step, uint8_t& fraction) {
+    uint32_t whole = (uint32_t)(per_step >> 8);
+    uint32_t part = (uint32_t)(per_step & 0xFF);
+    uint32_t low = (uint32_t)(steps & 0xFF) * part;   // Below 2^16
+    fraction = (uint8_t)low;
+    return (bam_t)steps * whole + (bam_t)(steps >> 8) * part + (low >> 8);
+}
+
+KinematicModel::KinematicModel() :
+    left_diameter_mm(0),
+    right_diameter_mm(0),
+    wheelbase_mm(0),
+    left(),
+    right(),
+    max_distance_mm(0),
+    max_angle_rad(0)
+{
+}
+
+void KinematicModel::configure(float left_diameter, float right_diameter, float wheelbase,
+                               uint16_t steps_per_revolution) {
+    left_diameter_mm = left_diameter;
+    right_diameter_mm = right_diameter;
+    wheelbase_mm = wheelbase;
+    
+    deriveWheel(left, left_diameter, wheelbase, steps_per_revolution);
+    deriveWheel(right, right_diameter, wheelbase, steps_per_revolution);
+    
+    // Each term of a conversion gets half the step budget, so their sum
+    // fits too; beyond +/-32767 the inputs no longer fit Q16.16 anyway
+    const float budget = KINEMATIC_MAX_STEPS / 2;
+    float max_distance = budget / fixedToFloat(max(left.steps_per_mm, right.steps_per_mm));
+    float max_angle = budget / fixedToFloat(max(left.steps_per_radian, right.steps_per_radian));
+    max_distance_mm = floatToFixed(min(max_distance, 32767.0f));
+    max_angle_rad = floatToFixed(min(max_angle, 32767.0f));
+}
+
+/**
+ * Derive one wheel's constants - the only float divides in the kinematics
+ */
+void KinematicModel::deriveWheel(WheelConstants& wheel, float diameter_mm, float wheelbase_mm,
+                                 uint16_t steps_per_revolution) {
+    const float frac_one = 4294967296.0f;       // 2^32, Q0.32
+    float circumference = PI * diameter_mm;
+    float steps_mm = steps_per_revolution / circumference;
+    float mm_step = circumference / steps_per_revolution;
+    
+    wheel.steps_per_mm = floatToFixed(steps_mm);
+    
+    // Each wheel travels wheelbase/2 per radian of rotation in place
+    wheel.steps_per_radian = floatToFixed(steps_mm * wheelbase_mm / 2.0);
+    
+    wheel.mm_per_step = (uint32_t)(mm_step * frac_one + 0.5f);
+    wheel.radians_per_step = (uint32_t)(mm_step / wheelbase_mm * frac_one + 0.5f);
+    wheel.bam_per_step = (int32_t)(mm_step / wheelbase_mm * BAM_PER_RADIAN * 256.0f + 0.5f);
+}
+
+/**
+ * Check that a movement's wheel steps stay within KINEMATIC_MAX_STEPS
+ */
+bool KinematicModel::inRange(fixed_t distance_mm, fixed_t angle_rad) const {
+    return labs(distance_mm) <= max_distance_mm && labs(angle_rad) <= max_angle_rad;
+}
+
+bool KinematicModel::toSteps(fixed_t distance_mm, fixed_t angle_rad, int& left_steps, int& right_steps) const {
+    left_steps = 0;
+    right_steps = 0;
+    if (!inRange(distance_mm, angle_rad)) {
+        return false;
+    }
+    
+    // Q16.16 x Q16.16 = Q16.16 wheel steps
+    // Left wheel travels less for a left turn
+    left_steps = roundSteps(multiplyFixed(distance_mm, left.steps_per_mm) -
+                            multiplyFixed(angle_rad, left.steps_per_radian));
+    right_steps = roundSteps(multiplyFixed(distance_mm, right.steps_per_mm) +
+                             multiplyFixed(angle_rad, right.steps_per_radian));
+    return true;
+}
+
+bool KinematicModel::toSteps(fixed_t distance_mm, fixed_t angle_rad, int& left_steps, int& right_steps,
+                             StepRemainder& remainder) const {
+    left_steps = 0;
+    right_steps = 0;
+    if (!inRange(distance_mm, angle_rad)) {
+        return false;
+    }
+    
+    left_steps = roundCarry(multiplyFixed(distance_mm, left.steps_per_mm) -
+                            multiplyFixed(angle_rad, left.steps_per_radian), remainder.left);
+    right_steps = roundCarry(multiplyFixed(distance_mm, right.steps_per_mm) +
+                             multiplyFixed(angle_rad, right.steps_per_radian), remainder.right);
+    return true;
+}
+
+void KinematicModel::toMovement(int left_steps, int right_steps, fixed_t& distance_mm, fixed_t& angle_rad) const {
+    // Steps x Q0.32 >> 16 = Q16.16; |steps| < 2^15 and constants below one keep it in range
+    fixed_t left_travel = multiplyFixed(left_steps, left.mm_per_step);
+    fixed_t right_travel = multiplyFixed(right_steps, right.mm_per_step);
+    
+    distance_mm = (left_travel + right_travel + 1) >> 1;
+    angle_rad = multiplyFixed(right_steps, right.radians_per_step) -
+                multiplyFixed(left_steps, left.radians_per_step);
+}
+
+void KinematicModel::toMovement(int left_steps, int right_steps, float& distance_mm, float& angle_rad) const {
+    const float scale = 1.0f / 4294967296.0f;  // Q0.32
+    float travel = (float)left_steps * (float)left.mm_per_step + (float)right_steps * (float)right.mm_per_step;
+    float turn = (float)right_steps * (float)right.radians_per_step - (float)left_steps * (float)left.radians_per_step;
+    
+    distance_mm = travel * (scale / 2.0f);
+    angle_rad = turn * scale;
+}
+
+bam_t KinematicModel::toHeadingChange(long left_steps, long right_steps) const {
+    // Q24.8 binary angle, rounded to whole units; 32-bit arithmetic wraps full turns
+    uint8_t left_fraction, right_fraction;
+    bam_t turn = turnProduct(right_steps, right.bam_per_step, right_fraction) -
+                 turnProduct(left_steps, left.bam_per_step, left_fraction);
+    return turn + (bam_t)(((int)right_fraction - (int)left_fraction + 128) >> 8);
+}
+
+float KinematicModel::getLeftDiameter() const {
+    return left_diameter_mm;
+}
+
+float KinematicModel::getRightDiameter() const {
+    return right_diameter_mm;
+}
+
+float KinematicModel::getWheelbase() const {
+    return wheelbase_mm;
+}
+
+const WheelConstants& KinematicModel::getLeftWheel() const {
+    return left;
+}
+
+const WheelConstants& KinematicModel::getRightWheel() const {
+    return right;
+}
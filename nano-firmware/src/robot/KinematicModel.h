@@ -0,0 +1,160 @@
+#ifndef KINEMATIC_MODEL_H
+#define KINEMATIC_MODEL_H
+
+#include <Arduino.h>
+#include "../BinaryAngle.h"
+
+/**
+ * Fixed-point number types
+ *
+ * The ATmega328 has no FPU, so every float divide in the kinematics costs
+ * hundreds of cycles. Distances and angles are carried as Q16.16
+ * (range +/-32768, resolution 1.5e-5); per-step constants smaller than one
+ * use Q0.32 to keep their relative precision.
+ *
+ * Products are built from 16x16-bit partial products in 32-bit registers:
+ * avr-gcc's 64-bit multiply is a library call several times slower.
+ */
+typedef int32_t fixed_t;                         // Q16.16
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE ((fixed_t)1 << FIXED_SHIFT)
+#define KINEMATIC_MAX_STEPS 32000                // Largest wheel step count one conversion returns (fits a 16-bit int)
+
+inline fixed_t floatToFixed(float value) {
+    return (fixed_t)(value * (float)FIXED_ONE + (value < 0 ? -0.5f : 0.5f));
+}
+
+inline float fixedToFloat(fixed_t value) {
+    return (float)value * (1.0f / (float)FIXED_ONE);
+}
+
+/**
+ * Per-wheel conversion constants
+ */
+struct WheelConstants {
+    fixed_t steps_per_mm;       // Q16.16 wheel steps per mm of wheel travel
+    fixed_t steps_per_radian;   // Q16.16 wheel steps per radian of robot rotation
+    uint32_t mm_per_step;       // Q0.32 wheel travel per step (wheels under 650mm across)
+    uint32_t radians_per_step;  // Q0.32 robot rotation per step of this wheel
+    int32_t bam_per_step;       // Q24.8 robot rotation per step in binary angle units (< 0.012 rad)
+};
+
+/**
+ * Sub-step wheel targets carried between movements
+ * A wheel's exact cumulative target is the whole steps already issued plus
+ * this fraction, so rounding each movement separately never accumulates.
+ */
+struct StepRemainder {
+    int32_t left;               // Fraction of a step in 1/2^16 units, [-0.5, 0.5)
+    int32_t right;
+};
+
+/**
+ * KinematicModel - Differential-drive conversions in fixed point
+ *
+ * Holds the calibrated geometry (effective left and right wheel diameters,
+ * wheelbase) and the constants derived from it. configure() is the only
+ * place that divides; converting a movement to wheel steps (and back) is a
+ * few integer multiplies. Rebuild the model only when the geometry changes.
+ *
+ * Wheels are calibrated separately because 28BYJ builds differ by a few
+ * percent per side: with equal diameters assumed, a straight line curves
+ * and every turn over- or under-shoots.
+ *
+ * Conventions match the rest of the robot: positive distance drives
+ * forward, positive angle turns counterclockwise (right wheel travels
+ * further).
+ *
+ * Usage:
+ *   KinematicModel model;
+ *   model.configure(25.0, 25.3, 30.0, 2048);
+ *   int left, right;
+ *   if (model.toSteps(floatToFixed(10.0), 0, left, right)) { ... }  // 10mm forward
+ */
+class KinematicModel {
+private:
+    float left_diameter_mm;     // Effective (calibrated) wheel diameters
+    float right_diameter_mm;
+    float wheelbase_mm;
+    WheelConstants left;
+    WheelConstants right;
+    fixed_t max_distance_mm;    // Largest |distance| converted (half the step budget)
+    fixed_t max_angle_rad;      // Largest |angle| converted (the other half)
+    
+    static void deriveWheel(WheelConstants& wheel, float diameter_mm, float wheelbase_mm,
+                            uint16_t steps_per_revolution);
+    bool inRange(fixed_t distance_mm, fixed_t angle_rad) const;
+    
+public:
+    // === CONSTRUCTOR ===
+    
+    /**
+     * Default constructor - call configure() before converting
+     */
+    KinematicModel();
+    
+    // === CONFIGURATION ===
+    
+    /**
+     * Store the geometry and precompute the conversion constants
+     * @param left_diameter_mm Effective left wheel diameter
+     * @param right_diameter_mm Effective right wheel diameter
+     * @param wheelbase_mm Distance between the wheel contact points
+     * @param steps_per_revolution Motor steps per wheel revolution
+     */
+    void configure(float left_diameter_mm, float right_diameter_mm, float wheelbase_mm,
+                   uint16_t steps_per_revolution);
+    
+    // === CONVERSIONS ===
+    
+    /**
+     * Wheel steps for a movement along an arc (rounded to the nearest step)
+     * @param distance_mm Q16.16 distance travelled by the robot centre
+     * @param angle_rad Q16.16 heading change
+     * @return false (and zero steps) if a wheel would need more than
+     *         KINEMATIC_MAX_STEPS; split such movements or reject them
+     */
+    bool toSteps(fixed_t distance_mm, fixed_t angle_rad, int& left_steps, int& right_steps) const;
+    
+    /**
+     * Wheel steps for a movement, rounding the cumulative target instead
+     * The carried remainder is added before rounding and replaced by the
+     * new one, so a chain of movements issues exactly the rounded sum of
+     * their steps (e.g. many small turnBy() calls).
+     * @param remainder Carried sub-step targets, updated in place (unchanged on failure)
+     */
+    bool toSteps(fixed_t distance_mm, fixed_t angle_rad, int& left_steps, int& right_steps,
+                 StepRemainder& remainder) const;
+    
+    /**
+     * Movement produced by a pair of wheel step counts
+     * @param distance_mm Receives the Q16.16 distance travelled by the robot centre
+     * @param angle_rad Receives the Q16.16 heading change
+     */
+    void toMovement(int left_steps, int right_steps, fixed_t& distance_mm, fixed_t& angle_rad) const;
+    
+    /**
+     * Movement produced by a pair of wheel step counts, in float
+     * For callers that sum many small movements (odometry): steps times
+     * the Q0.32 constants in float, without rounding to Q16.16 first.
+     */
+    void toMovement(int left_steps, int right_steps, float& distance_mm, float& angle_rad) const;
+    
+    /**
+     * Heading change produced by a pair of wheel step counts
+     * Integer only, so headings summed from steps are exact and repeatable.
+     * Wraps modulo one turn.
+     */
+    bam_t toHeadingChange(long left_steps, long right_steps) const;
+    
+    // === GEOMETRY ===
+    
+    float getLeftDiameter() const;
+    float getRightDiameter() const;
+    float getWheelbase() const;
+    const WheelConstants& getLeftWheel() const;
+    const WheelConstants& getRightWheel() const;
+};
+
+#endif // KINEMATIC_MODEL_H
@@ -0,0 +1,57 @@
+#include "MotionQueue.h"
+
+#define MOTION_QUEUE_MASK (MOTION_QUEUE_SIZE - 1)
+
+MotionQueue::MotionQueue() :
+    head(0),
+    tail(0)
+{
+}
+
+bool MotionQueue::push(const MotionSegment& segment) {
+    if (isFull()) {
+        return false;
+    }
+    
+    segments[head & MOTION_QUEUE_MASK] = segment;
+    head++;
+    return true;
+}
+
+bool MotionQueue::pop(MotionSegment& segment) {
+    if (isEmpty()) {
+        return false;
+    }
+    
+    segment = segments[tail & MOTION_QUEUE_MASK];
+    tail++;
+    return true;
+}
+
+const MotionSegment* MotionQueue::peek() const {
+    if (isEmpty()) {
+        return nullptr;
+    }
+    return &segments[tail & MOTION_QUEUE_MASK];
+}
+
+void MotionQueue::clear() {
+    tail = head;
+}
+
+bool MotionQueue::isEmpty() const {
+    return head == tail;
+}
+
+bool MotionQueue::isFull() const {
+    return count() >= MOTION_QUEUE_SIZE;
+}
+
+uint8_t MotionQueue::count() const {
+    // Free-running indices, so the difference is the fill level
+    return (uint8_t)(head - tail);
+}
+
+uint8_t MotionQueue::getFreeSlots() const {
+    return MOTION_QUEUE_SIZE - count();
+}
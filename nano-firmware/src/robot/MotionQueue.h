@@ -0,0 +1,116 @@
+#ifndef MOTION_QUEUE_H
+#define MOTION_QUEUE_H
+
+#include <Arduino.h>
+
+#ifndef MOTION_QUEUE_SIZE
+#define MOTION_QUEUE_SIZE 8                      // Must be a power of two
+#endif
+
+/**
+ * Motion segment types
+ */
+enum SegmentType : uint8_t {
+    SEGMENT_TRAVEL,     // Pen-up move to (x, y)
+    SEGMENT_DRAW,       // Pen-down line to (x, y)
+    SEGMENT_TURN,       // Rotate in place by x radians
+    SEGMENT_PEN_UP,     // Raise the pen
+    SEGMENT_PEN_DOWN,   // Lower the pen
+    SEGMENT_ARC_CW,     // Pen-down clockwise arc around (cx, cy) to (x, y)
+    SEGMENT_ARC_CCW,    // Pen-down counter-clockwise arc around (cx, cy) to (x, y)
+    SEGMENT_CURVE       // Pen-down cubic Bezier via (cx, cy) and (c2x, c2y) to (x, y)
+};
+
+/**
+ * Motion segment - one queued robot command
+ */
+struct MotionSegment {
+    uint8_t type;       // SegmentType
+    bool reverse;       // Drive backward to (x, y) (TRAVEL/DRAW)
+    float x;            // Target X in mm (TRAVEL/DRAW/ARC/CURVE), angle delta in radians (TURN)
+    float y;            // Target Y in mm (TRAVEL/DRAW/ARC/CURVE)
+    float speed;        // mm/s (TRAVEL/DRAW/ARC/CURVE) or rad/s (TURN)
+    float cx;           // Arc centre X (ARC) or first control point X (CURVE) in mm
+    float cy;           // Arc centre Y (ARC) or first control point Y (CURVE) in mm
+    float c2x;          // Second control point X in mm (CURVE)
+    float c2y;          // Second control point Y in mm (CURVE)
+};
+
+/**
+ * MotionQueue - Fixed-capacity ring buffer of pending motion segments
+ *
+ * Lets the host stream segments while the robot is still executing the
+ * previous one, so polylines run without a round trip between segments.
+ *
+ * Usage:
+ *   MotionQueue queue;
+ *   MotionSegment segment = {SEGMENT_DRAW, false, 10.0, 20.0, 10.0};
+ *   if (!queue.push(segment)) {
+ *     // Queue full - retry after the robot drains a segment
+ *   }
+ */
+class MotionQueue {
+private:
+    MotionSegment segments[MOTION_QUEUE_SIZE];
+    uint8_t head;       // Next free slot
+    uint8_t tail;       // Oldest pending segment
+    
+public:
+    // === CONSTRUCTOR ===
+    
+    /**
+     * Default constructor - starts empty
+     */
+    MotionQueue();
+    
+    // === QUEUE OPERATIONS ===
+    
+    /**
+     * Append a segment
+     * @param segment Segment to copy into the queue
+     * @return true if queued, false if the queue is full
+     */
+    bool push(const MotionSegment& segment);
+    
+    /**
+     * Remove the oldest segment
+     * @param segment Receives the removed segment
+     * @return true if a segment was removed, false if empty
+     */
+    bool pop(MotionSegment& segment);
+    
+    /**
+     * Get the oldest segment without removing it
+     * @return Pointer to the segment, or nullptr if empty
+     */
+    const MotionSegment* peek() const;
+    
+    /**
+     * Discard all pending segments
+     */
+    void clear();
+    
+    // === STATE QUERIES ===
+    
+    /**
+     * Check if no segments are pending
+     */
+    bool isEmpty() const;
+    
+    /**
+     * Check if no more segments can be queued
+     */
+    bool isFull() const;
+    
+    /**
+     * Get number of pending segments
+     */
+    uint8_t count() const;
+    
+    /**
+     * Get number of segments that can still be queued
+     */
+    uint8_t getFreeSlots() const;
+};
+
+#endif // MOTION_QUEUE_H
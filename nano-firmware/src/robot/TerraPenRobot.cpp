@@ -1,4 +1,5 @@
 #include "TerraPenRobot.h"
+#include "../ErrorSystem.h"
 
 /**
  * Initialize the robot with hardware configuration from global config
@@ -11,10 +12,17 @@ void TerraPenRobot::begin() {
                       g_config.hardware.motor_r_pins[2], g_config.hardware.motor_r_pins[3]);
     pen_servo.begin(g_config.hardware.servo_pin);
     
-    // Set motor speeds based on configuration
-    float speed_sps = 1000000.0 / g_config.hardware.step_delay_us;
-    left_motor.setSpeed(speed_sps);
-    right_motor.setSpeed(speed_sps);
+    // Steps-per-mm and steps-per-radian for all movement planning
+    rebuildKinematics();
+    
+    // Start timer-driven stepping (step rate comes from g_config.hardware.step_delay_us)
+    step_engine.begin(&left_motor, &right_motor);
+    
+    // Ramp from the slowest to the fastest step delay so moves can cruise at
+    // the hardware limit without stalling on start-up
+    step_engine.configureRamp(g_config.hardware.max_step_delay_us,
+                              g_config.hardware.min_step_delay_us,
+                              g_config.hardware.acceleration_steps);
     
     // Initialize state
     state = IDLE;
@@ -22,11 +30,36 @@ void TerraPenRobot::begin() {
     movement_active = false;
     
     // Initialize position tracking (Phase 2)
-    current_x = 0.0;
-    current_y = 0.0;
-    current_angle = 0.0;
+    anchor_x = 0.0;
+    anchor_y = 0.0;
+    anchor_heading = 0;
+    anchor_left_steps = 0;
+    anchor_right_steps = 0;
+    anchor_block = 0;
+    queued_blocks = 0;
     coordinate_movement = false;
-    movement_speed_mms = 15.0;
+    movement_speed_mms = g_config.getCruiseSpeedMms();
+    movement_speed_rad_s = 0.5;
+    movement_interval_us = 0;
+    segment_turn_left = 0;
+    segment_turn_right = 0;
+    segment_turn_interval_us = 0;
+    segment_run_left = 0;
+    segment_run_right = 0;
+    segment_run_interval_us = 0;
+    segment_turn_queued = false;
+    tracking_movement = false;
+    tracking_handover = false;
+    segment_start_x = 0.0;
+    segment_start_y = 0.0;
+    segment_reverse = false;
+    curve_start_x = 0.0;
+    curve_start_y = 0.0;
+    curve_t = 0.0;
+    curve_active = false;
+    motion_profile = (MotionProfile)g_config.hardware.motion_profile;
+    path_mode = (PathMode)g_config.hardware.path_mode;
+    reverse_mode = (ReverseMode)g_config.hardware.reverse_mode;
     target_x = 0.0;
     target_y = 0.0;
     
@@ -35,11 +68,18 @@ void TerraPenRobot::begin() {
     target_right_steps = 0;
     current_left_steps = 0;
     current_right_steps = 0;
+    movement_origin_left = 0;
+    movement_origin_right = 0;
+    movement_scheduled = false;
     
     // Initialize step counters
     left_steps_total = 0;
     right_steps_total = 0;
     
+    // Initialize queued planning at the start pose
+    motion_queue.clear();
+    syncPlannedPose();
+    
     // Set pen to up position initially
     pen_servo.setAngle(g_config.hardware.servo_pen_up_angle);
 }
@@ -53,12 +93,7 @@ bool TerraPenRobot::moveForward(int steps) {
     }
     
     // Set movement targets
-    target_left_steps = steps;
-    target_right_steps = steps;
-    current_left_steps = 0;
-    current_right_steps = 0;
-    movement_active = true;
-    coordinate_movement = false;  // Step-based movement
+    startStepMovement(steps, steps);
     
     setState(MOVING);
     return true;
@@ -73,12 +108,7 @@ bool TerraPenRobot::moveBackward(int steps) {
     }
     
     // Set movement targets (negative for backward)
-    target_left_steps = -steps;
-    target_right_steps = -steps;
-    current_left_steps = 0;
-    current_right_steps = 0;
-    movement_active = true;
-    coordinate_movement = false;  // Step-based movement
+    startStepMovement(-steps, -steps);
     
     setState(MOVING);
     return true;
@@ -93,12 +123,7 @@ bool TerraPenRobot::turnLeft(int steps) {
     }
     
     // For differential drive: left turn = right motor forward, left motor backward
-    target_left_steps = -steps;
-    target_right_steps = steps;
-    current_left_steps = 0;
-    current_right_steps = 0;
-    movement_active = true;
-    coordinate_movement = false;  // Step-based movement
+    startStepMovement(-steps, steps);
     
     setState(MOVING);
     return true;
@@ -113,12 +138,7 @@ bool TerraPenRobot::turnRight(int steps) {
     }
     
     // For differential drive: right turn = left motor forward, right motor backward
-    target_left_steps = steps;
-    target_right_steps = -steps;
-    current_left_steps = 0;
-    current_right_steps = 0;
-    movement_active = true;
-    coordinate_movement = false;  // Step-based movement
+    startStepMovement(steps, -steps);
     
     setState(MOVING);
     return true;
@@ -128,74 +148,103 @@ bool TerraPenRobot::turnRight(int steps) {
  * Move to specific coordinates with pen up
  */
 bool TerraPenRobot::moveTo(float x, float y, float speed_mms) {
-    if (isBusy() || !isValidPosition(x, y) || speed_mms <= 0) {
+    if (!isValidPosition(x, y) || speed_mms <= 0) {
         return false;
     }
     
-    // Ensure pen is up for movement
-    penUp();
-    
-    // Set coordinate movement target
-    target_x = x;
-    target_y = y;
-    movement_speed_mms = speed_mms;
-    coordinate_movement = true;
-    movement_active = true;
-    
-    setState(MOVING);
-    return true;
+    return enqueueSegment(SEGMENT_TRAVEL, x, y, speed_mms);
 }
 
 /**
  * Draw line to specific coordinates with pen down
  */
 bool TerraPenRobot::drawTo(float x, float y, float speed_mms) {
-    if (isBusy() || !isValidPosition(x, y) || speed_mms <= 0) {
+    if (!isValidPosition(x, y) || speed_mms <= 0) {
         return false;
     }
     
-    // Ensure pen is down for drawing
-    penDown();
-    
-    // Set coordinate movement target
-    target_x = x;
-    target_y = y;
-    movement_speed_mms = speed_mms;
-    coordinate_movement = true;
-    movement_active = true;
-    
-    setState(MOVING);
-    return true;
+    return enqueueSegment(SEGMENT_DRAW, x, y, speed_mms);
 }
 
 /**
  * Move by relative offset with pen up
+ * Offset is relative to where queued motion ends
  */
 bool TerraPenRobot::moveBy(float dx, float dy, float speed_mms) {
-    return moveTo(current_x + dx, current_y + dy, speed_mms);
+    return moveTo(plan_x + dx, plan_y + dy, speed_mms);
 }
 
 /**
  * Draw by relative offset with pen down
+ * Offset is relative to where queued motion ends
  */
 bool TerraPenRobot::drawBy(float dx, float dy, float speed_mms) {
-    return drawTo(current_x + dx, current_y + dy, speed_mms);
+    return drawTo(plan_x + dx, plan_y + dy, speed_mms);
+}
+
+/**
+ * Draw an arc with pen down around (cx, cy), ending at the bearing of (x, y)
+ * The radius is set by where queued motion ends; if (x, y) is that same
+ * point, a full circle is drawn.
+ */
+bool TerraPenRobot::arcTo(float cx, float cy, float x, float y, bool clockwise, float speed_mms) {
+    if (!isValidPosition(x, y) || speed_mms <= 0) {
+        return false;
+    }
+    
+    float dx = plan_x - cx;
+    float dy = plan_y - cy;
+    if (sqrt(dx * dx + dy * dy) < 0.5) {
+        return false;  // Start point is on the centre, no defined radius
+    }
+    
+    // The arc can bulge past the workspace even when both ends are inside
+    if (!isValidArc(cx, cy, x, y, clockwise)) {
+        return false;
+    }
+    
+    return enqueueSegment(clockwise ? SEGMENT_ARC_CW : SEGMENT_ARC_CCW, x, y, speed_mms, cx, cy);
+}
+
+/**
+ * Draw a full circle with pen down, starting tangent to the queued heading
+ * Clockwise circles have their centre to the right of the heading.
+ */
+bool TerraPenRobot::circle(float radius, bool clockwise, float speed_mms) {
+    if (radius < 0.5) {
+        return false;
+    }
+    
+    // Bearing from the centre to the start point is a quarter turn off the heading
+    bam_t bearing = plan_heading + (clockwise ? -BAM_QUARTER_TURN : BAM_QUARTER_TURN);
+    float cx = plan_x - radius * TP_SIN_BAM(bearing);
+    float cy = plan_y - radius * TP_COS_BAM(bearing);
+    return arcTo(cx, cy, plan_x, plan_y, clockwise, speed_mms);
+}
+
+/**
+ * Draw a cubic Bezier with pen down from where queued motion ends
+ * The curve is flattened on the robot, one chord at a time, into chords
+ * that stay within one wheel step of the true curve.
+ */
+bool TerraPenRobot::curveTo(float c1x, float c1y, float c2x, float c2y, float x, float y, float speed_mms) {
+    if (!isValidPosition(x, y) || speed_mms <= 0) {
+        return false;
+    }
+    
+    return enqueueSegment(SEGMENT_CURVE, x, y, speed_mms, c1x, c1y, c2x, c2y);
 }
 
 /**
  * Turn to absolute angle
  */
 bool TerraPenRobot::turnTo(float angle_radians, float speed_rad_s) {
-    if (isBusy() || speed_rad_s <= 0) {
+    if (speed_rad_s <= 0) {
         return false;
     }
     
-    // Calculate required turn angle
-    float delta_angle = angle_radians - current_angle;
-    
-    // Normalize to [-PI, PI]
-    while (delta_angle > PI) delta_angle -= 2 * PI;
-    while (delta_angle < -PI) delta_angle += 2 * PI;
+    // Shortest turn from the heading queued motion ends at (wraps for free)
+    float delta_angle = bamToRadians(radiansToBam(angle_radians) - plan_heading);
     
     return turnBy(delta_angle, speed_rad_s);
 }
@@ -204,40 +253,152 @@ bool TerraPenRobot::turnTo(float angle_radians, float speed_rad_s) {
  * Turn by relative angle
  */
 bool TerraPenRobot::turnBy(float delta_angle, float speed_rad_s) {
-    if (isBusy() || speed_rad_s <= 0) {
+    if (speed_rad_s <= 0) {
         return false;
     }
     
-    // Calculate steps needed for rotation
-    int left_steps, right_steps;
-    calculateSteps(0.0, delta_angle, left_steps, right_steps);
+    return enqueueSegment(SEGMENT_TURN, delta_angle, 0.0, speed_rad_s);
+}
+
+/**
+ * Select the velocity profile for subsequent movements
+ * S-curve ramps are jerk-limited, which reduces ringing in the gear train
+ * and pen mount at the cost of slightly longer ramps. The look-ahead
+ * planner only links trapezoid blocks, so S-curve blocks slow to the ramp's
+ * start speed at every block boundary (each leg of a path, and the chunks
+ * a long move is split into); a warning is reported when it is selected.
+ */
+void TerraPenRobot::setMotionProfile(MotionProfile profile) {
+    if (profile == PROFILE_SCURVE && motion_profile != PROFILE_SCURVE) {
+        REPORT_ERROR(ERR_CONFIG_CONFLICT, "MotionProfile", "S-curve blocks stop at every junction");
+    }
+    motion_profile = profile;
+}
+
+/**
+ * Get the velocity profile used for new movements
+ */
+MotionProfile TerraPenRobot::getMotionProfile() const {
+    return motion_profile;
+}
+
+/**
+ * Select how subsequent moveTo/drawTo segments are followed
+ * Tracking steers through gentle bends without stopping; bends sharper than
+ * tracking_corner_rad still stop and turn in place.
+ */
+void TerraPenRobot::setPathMode(PathMode mode) {
+    path_mode = mode;
+}
+
+/**
+ * Get the path following mode used for new coordinate moves
+ */
+PathMode TerraPenRobot::getPathMode() const {
+    return path_mode;
+}
+
+/**
+ * Select when subsequent moveTo/drawTo may drive backward
+ * A target more than 90 degrees off heading is reached in reverse, so the
+ * spin before it is at most a quarter turn instead of nearly a half turn.
+ */
+void TerraPenRobot::setReverseMode(ReverseMode mode) {
+    reverse_mode = mode;
+}
+
+/**
+ * Get the reverse driving mode used for new coordinate moves
+ */
+ReverseMode TerraPenRobot::getReverseMode() const {
+    return reverse_mode;
+}
+
+/**
+ * Set the calibrated wheel geometry
+ * Diameters are effective (measured) values, which differ by a few percent
+ * per wheel on 28BYJ builds. The nominal diameter becomes their mean and the
+ * per-wheel scales hold the difference. Queued moves were planned with the
+ * old constants, so geometry only changes while the robot is stopped.
+ */
+bool TerraPenRobot::setGeometry(float left_diameter_mm, float right_diameter_mm, float wheelbase_mm) {
+    if (hasPendingMotion() || !step_engine.isIdle()) {
+        return false;
+    }
+    if (left_diameter_mm <= 0 || right_diameter_mm <= 0 || wheelbase_mm <= 0) {
+        return false;
+    }
     
-    // Set movement targets
-    target_left_steps = left_steps;
-    target_right_steps = right_steps;
-    current_left_steps = 0;
-    current_right_steps = 0;
-    movement_active = true;
-    coordinate_movement = false;  // Step-based movement
+    float nominal = (left_diameter_mm + right_diameter_mm) / 2.0;
+    g_config.hardware.wheel_diameter_mm = nominal;
+    g_config.hardware.left_wheel_scale = left_diameter_mm / nominal;
+    g_config.hardware.right_wheel_scale = right_diameter_mm / nominal;
+    g_config.hardware.wheelbase_mm = wheelbase_mm;
     
-    setState(MOVING);
+    rebuildKinematics();
     return true;
 }
 
+/**
+ * Get the wheel geometry used for planning and pose tracking
+ */
+const KinematicModel& TerraPenRobot::getKinematics() const {
+    return kinematics;
+}
+
+/**
+ * Lower the coil hold current while the wheels are stopped
+ * The step engine returns to full current when the next block starts.
+ */
+void TerraPenRobot::setIdleHold(uint8_t percent) {
+    step_engine.setIdleHold(percent);
+}
+
+/**
+ * Get number of segments that can be queued without being rejected
+ */
+uint8_t TerraPenRobot::getFreeSlots() const {
+    return motion_queue.getFreeSlots();
+}
+
+/**
+ * Drop queued segments; the active movement runs to completion
+ */
+void TerraPenRobot::clearQueue() {
+    motion_queue.clear();
+    plan_x = queued_x;
+    plan_y = queued_y;
+    plan_heading = queued_heading;
+    curve_active = false;  // Unstarted chords of a curve are queued motion too
+    if (movement_active && coordinate_movement) {
+        // Active coordinate move still ends at its target
+        plan_x = target_x;
+        plan_y = target_y;
+    }
+}
+
 /**
  * Raise the pen
+ * Queued behind any pending motion so it happens at the right point in the path
  */
 void TerraPenRobot::penUp() {
-    pen_servo.setAngle(g_config.hardware.servo_pen_up_angle);
-    pen_is_down = false;
+    if (hasPendingMotion()) {
+        enqueueSegment(SEGMENT_PEN_UP, 0.0, 0.0, 0.0);
+        return;
+    }
+    applyPen(false);
 }
 
 /**
  * Lower the pen
+ * Queued behind any pending motion so it happens at the right point in the path
  */
 void TerraPenRobot::penDown() {
-    pen_servo.setAngle(g_config.hardware.servo_pen_down_angle);
-    pen_is_down = true;
+    if (hasPendingMotion()) {
+        enqueueSegment(SEGMENT_PEN_DOWN, 0.0, 0.0, 0.0);
+        return;
+    }
+    applyPen(true);
 }
 
 /**
@@ -266,7 +427,14 @@ bool TerraPenRobot::isBusy() const {
  */
 void TerraPenRobot::emergencyStop() {
     stopAllMotors();
+    motion_queue.clear();
     movement_active = false;
+    
+    // Nothing is scheduled any more; plan from where the robot stopped
+    syncStepCounts();
+    rebaseAnchor();
+    syncPlannedPose();
+    step_remainder = StepRemainder();
     setState(EMERGENCY_STOP);
 }
 
@@ -276,7 +444,12 @@ void TerraPenRobot::emergencyStop() {
 void TerraPenRobot::clearError() {
     if (state == ERROR || state == EMERGENCY_STOP) {
         stopAllMotors();
+        motion_queue.clear();
         movement_active = false;
+        syncStepCounts();
+        rebaseAnchor();
+        syncPlannedPose();
+        step_remainder = StepRemainder();
         setState(IDLE);
     }
 }
@@ -297,43 +470,76 @@ long TerraPenRobot::getRightStepsTotal() const {
 
 /**
  * Reset step counters (for calibration)
+ * Refused while motion is pending: the engine keeps stepping between
+ * reading its positions and zeroing them, and those steps would be lost.
  */
-void TerraPenRobot::resetStepCounts() {
+bool TerraPenRobot::resetStepCounts() {
+    if (hasPendingMotion() || !step_engine.isIdle()) {
+        return false;
+    }
+    
+    // Keep targets relative to the new zero
+    queued_left_steps -= left_steps_total;
+    queued_right_steps -= right_steps_total;
+    
+    // The anchor and scheduled block ends move with them
+    anchor_left_steps -= left_steps_total;
+    anchor_right_steps -= right_steps_total;
+    for (uint8_t slot = 0; slot < STEP_ENGINE_QUEUE_SIZE; slot++) {
+        block_end_left[slot] -= left_steps_total;
+        block_end_right[slot] -= right_steps_total;
+    }
+    
+    step_engine.resetPositions();
     left_steps_total = 0;
     right_steps_total = 0;
+    return true;
 }
 
 /**
- * Get current position and orientation
+ * Get current position and orientation (evaluated from the step state)
  */
 Position TerraPenRobot::getCurrentPosition() const {
-    return Position(current_x, current_y, current_angle);
+    float x, y;
+    bam_t heading;
+    evaluatePose(x, y, heading);
+    return Position(x, y, bamToRadians(heading));
 }
 
 /**
  * Reset position tracking (for calibration)
+ * Only while stopped, like resetStepCounts(); returns false otherwise.
  */
-void TerraPenRobot::resetPosition(float x, float y, float angle) {
-    current_x = x;
-    current_y = y;
-    current_angle = angle;
+bool TerraPenRobot::resetPosition(float x, float y, float angle) {
+    if (hasPendingMotion() || !step_engine.isIdle()) {
+        return false;
+    }
+    
+    // Steps issued before now no longer count
+    uint8_t retired;
+    step_engine.getProgress(retired, anchor_left_steps, anchor_right_steps);
+    anchor_x = x;
+    anchor_y = y;
+    anchor_heading = radiansToBam(angle);
+    anchor_block = retired;
     
-    // Normalize angle to [-PI, PI]
-    while (current_angle > PI) current_angle -= 2 * PI;
-    while (current_angle < -PI) current_angle += 2 * PI;
+    // Queued moves are planned from the new pose
+    syncPlannedPose();
+    step_remainder = StepRemainder();
     
     // Reset step counters to maintain consistency
-    resetStepCounts();
+    return resetStepCounts();
 }
 
 /**
- * Check if robot is at target position
+ * Check if the robot has arrived where its planned movement ends
+ * Compared in step space, so there is no distance tolerance: true once
+ * the active movement is fully scheduled and every step has been issued.
  */
 bool TerraPenRobot::isAtTarget() const {
-    if (!coordinate_movement) {
-        return isMovementComplete();
-    }
-    return isAtTargetPosition();
+    return !movement_active &&
+           left_steps_total == queued_left_steps &&
+           right_steps_total == queued_right_steps;
 }
 
 /**
@@ -344,6 +550,42 @@ bool TerraPenRobot::isValidPosition(float x, float y) const {
             y >= g_config.hardware.workspace_min_y && y <= g_config.hardware.workspace_max_y);
 }
 
+/**
+ * Check that an arc from where queued motion ends stays in the workspace
+ * The workspace is a rectangle, so besides the (projected) end point only
+ * the circle's four axis extremes can leave it, and only those the sweep
+ * passes through count. Sweep matches planArcMovement().
+ */
+bool TerraPenRobot::isValidArc(float cx, float cy, float x, float y, bool clockwise) const {
+    float dx = plan_x - cx;
+    float dy = plan_y - cy;
+    float radius = sqrt(dx * dx + dy * dy);
+    bam_t start_bearing = radiansToBam(TP_ATAN2(dx, dy));
+    bam_t end_bearing = radiansToBam(TP_ATAN2(x - cx, y - cy));
+    
+    // Angle swept from the start, in the direction of travel; an end on the start point is a full circle
+    float sweep = bamToPositiveRadians(clockwise ? end_bearing - start_bearing : start_bearing - end_bearing);
+    if (sweep * radius < 0.5) sweep += 2 * PI;
+    
+    if (!isValidPosition(cx + radius * TP_SIN_BAM(end_bearing), cy + radius * TP_COS_BAM(end_bearing))) {
+        return false;
+    }
+    
+    // Bearings 0, 90, 180 and 270 degrees reach furthest north, east, south and west
+    static const int8_t EXTREME_X[4] = {0, 1, 0, -1};
+    static const int8_t EXTREME_Y[4] = {1, 0, -1, 0};
+    for (uint8_t quadrant = 0; quadrant < 4; quadrant++) {
+        bam_t extreme = (bam_t)quadrant * BAM_QUARTER_TURN;
+        float reach = bamToPositiveRadians(clockwise ? extreme - start_bearing : start_bearing - extreme);
+        if (reach > sweep) continue;
+        
+        if (!isValidPosition(cx + radius * EXTREME_X[quadrant], cy + radius * EXTREME_Y[quadrant])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Main update function - call every loop iteration
  * Coordinates the non-blocking hardware drivers
@@ -352,95 +594,490 @@ void TerraPenRobot::update() {
     // Update servo driver for smooth movements
     pen_servo.update();
     
-    // Execute movement if active
-    if (movement_active && state == MOVING) {
-        if (coordinate_movement) {
+    // Steps are issued by the step engine; pick up its progress
+    step_engine.service();
+    syncStepCounts();
+    
+    if (state != MOVING) {
+        return;
+    }
+    
+    // Keep the step schedule filled for the active movement
+    if (movement_active) {
+        if (coordinate_movement && tracking_movement) {
+            executeTrackingMovement();
+        } else if (coordinate_movement) {
             executeCoordinateMovement();
         } else {
             executeMovement();
         }
         
-        // Check if movement is complete
-        if ((coordinate_movement && isAtTargetPosition()) || 
-            (!coordinate_movement && isMovementComplete())) {
+        // Once every block is scheduled the engine finishes it on its own
+        if (movement_scheduled) {
             movement_active = false;
             coordinate_movement = false;
-            setState(IDLE);
         }
     }
     
-    // Update position estimate based on step changes
-    updatePositionEstimate();
+    // Plan the next segment behind the scheduled blocks so the look-ahead
+    // can carry speed through the junction
+    if (!movement_active) {
+        startNextSegment();
+    }
+    
+    // Idle once everything has been planned and the engine has drained
+    if (!movement_active && motion_queue.isEmpty() && step_engine.isIdle()) {
+        syncPlannedPose();
+        setState(IDLE);
+    }
 }
 
 /**
- * Execute coordinated movement using non-blocking drivers
+ * Append a segment to the motion queue and start it if the robot is idle
+ * Updates the planned end pose so later relative/heading moves chain from it
  */
-void TerraPenRobot::executeMovement() {
-    bool left_step_taken = false;
-    bool right_step_taken = false;
-    
-    // Handle left motor
-    if (current_left_steps != target_left_steps && left_motor.isReady()) {
-        if (target_left_steps > 0) {
-            // Forward
-            if (current_left_steps < target_left_steps) {
-                if (left_motor.stepForward()) {
-                    current_left_steps++;
-                    left_steps_total++;
-                    left_step_taken = true;
-                }
-            }
-        } else {
-            // Backward
-            if (current_left_steps > target_left_steps) {
-                if (left_motor.stepBackward()) {
-                    current_left_steps--;
-                    left_steps_total--;
-                    left_step_taken = true;
-                }
-            }
+bool TerraPenRobot::enqueueSegment(uint8_t type, float x, float y, float speed, float cx, float cy,
+                                   float c2x, float c2y) {
+    if (state == ERROR || state == EMERGENCY_STOP) {
+        return false;
+    }
+    
+    // Decide direction now, from the planned heading, so plan_heading stays exact
+    bool reverse = false;
+    float dx = x - plan_x;
+    float dy = y - plan_y;
+    bool moves = !isWithinStep(sqrt(dx * dx + dy * dy));
+    if (moves && (type == SEGMENT_TRAVEL || type == SEGMENT_DRAW) &&
+        (reverse_mode == REVERSE_ALWAYS || (reverse_mode == REVERSE_TRAVEL && type == SEGMENT_TRAVEL))) {
+        bam_t angle_diff = radiansToBam(TP_ATAN2(dx, dy)) - plan_heading;
+        reverse = bamMagnitude(angle_diff) > BAM_QUARTER_TURN;
+    }
+    
+    // Every block planned from the segment must fit the 16-bit step counts
+    float extent = 0.0;
+    float sweep = 0.0;
+    if (type == SEGMENT_TRAVEL || type == SEGMENT_DRAW) {
+        extent = sqrt(dx * dx + dy * dy);
+    } else if (type == SEGMENT_ARC_CW || type == SEGMENT_ARC_CCW) {
+        sweep = 2 * PI;
+        extent = sweep * sqrt((plan_x - cx) * (plan_x - cx) + (plan_y - cy) * (plan_y - cy));
+    } else if (type == SEGMENT_CURVE) {
+        // Chords are never longer than the control polygon
+        extent = sqrt((cx - plan_x) * (cx - plan_x) + (cy - plan_y) * (cy - plan_y)) +
+                 sqrt((c2x - cx) * (c2x - cx) + (c2y - cy) * (c2y - cy)) +
+                 sqrt((x - c2x) * (x - c2x) + (y - c2y) * (y - c2y));
+    } else if (type == SEGMENT_TURN) {
+        sweep = x;
+    }
+    if (!fitsStepRange(extent, 0.0) || !fitsStepRange(0.0, sweep)) {
+        return false;
+    }
+    
+    MotionSegment segment = {type, reverse, x, y, speed, cx, cy, c2x, c2y};
+    if (!motion_queue.push(segment)) {
+        return false;  // Queue full, caller retries once a segment completes
+    }
+    
+    // Track where the robot will be once this segment has run
+    if (type == SEGMENT_TRAVEL || type == SEGMENT_DRAW) {
+        if (moves) {
+            // Backing up leaves the robot facing away from the target
+            plan_heading = radiansToBam(TP_ATAN2(dx, dy)) + (reverse ? BAM_HALF_TURN : 0);
+        }
+        plan_x = x;
+        plan_y = y;
+    } else if (type == SEGMENT_ARC_CW || type == SEGMENT_ARC_CCW) {
+        // Arc ends on its circle at the bearing of (x, y), tangent to it
+        float radius = sqrt((plan_x - cx) * (plan_x - cx) + (plan_y - cy) * (plan_y - cy));
+        float bearing = TP_ATAN2(x - cx, y - cy);
+        plan_x = cx + radius * TP_SIN(bearing);
+        plan_y = cy + radius * TP_COS(bearing);
+        plan_heading = radiansToBam(bearing) + ((type == SEGMENT_ARC_CW) ? BAM_QUARTER_TURN : -BAM_QUARTER_TURN);
+    } else if (type == SEGMENT_CURVE) {
+        // Curve leaves along its last non-degenerate control leg
+        float from_x = c2x, from_y = c2y;
+        if (sqrt((x - from_x) * (x - from_x) + (y - from_y) * (y - from_y)) < 0.5) {
+            from_x = cx;
+            from_y = cy;
+        }
+        if (sqrt((x - from_x) * (x - from_x) + (y - from_y) * (y - from_y)) < 0.5) {
+            from_x = plan_x;
+            from_y = plan_y;
         }
+        if (sqrt((x - from_x) * (x - from_x) + (y - from_y) * (y - from_y)) >= 0.5) {
+            plan_heading = radiansToBam(TP_ATAN2(x - from_x, y - from_y));
+        }
+        plan_x = x;
+        plan_y = y;
+    } else if (type == SEGMENT_TURN) {
+        plan_heading += radiansToBam(x);
     }
     
-    // Handle right motor
-    if (current_right_steps != target_right_steps && right_motor.isReady()) {
-        if (target_right_steps > 0) {
-            // Forward
-            if (current_right_steps < target_right_steps) {
-                if (right_motor.stepForward()) {
-                    current_right_steps++;
-                    right_steps_total++;
-                    right_step_taken = true;
-                }
+    // Start right away if nothing else is running (or once the pen settles)
+    if (state == IDLE && !movement_active) {
+        setState(MOVING);
+        startNextSegment();
+    }
+    return true;
+}
+
+/**
+ * Pop queued segments until one starts a movement
+ * Pen segments are applied immediately as they are reached
+ */
+bool TerraPenRobot::startNextSegment() {
+    // Chords of a curve come before anything queued behind it
+    if (curve_active && startNextCurveChord()) {
+        return true;
+    }
+    
+    MotionSegment segment;
+    while (!motion_queue.isEmpty()) {
+        const MotionSegment* next = motion_queue.peek();
+        
+        // Pen changes happen where the robot actually is, so they start once
+        // the schedule is ramping down and overlap the final deceleration
+        if (segmentChangesPen(*next)) {
+            if (!step_engine.isStopping()) {
+                return false;
             }
-        } else {
-            // Backward
-            if (current_right_steps > target_right_steps) {
-                if (right_motor.stepBackward()) {
-                    current_right_steps--;
-                    right_steps_total--;
-                    right_step_taken = true;
+            applyPen(!pen_is_down);
+        }
+        
+        // Motion waits only for whatever settle time the pen has left
+        if (next->type != SEGMENT_PEN_UP && next->type != SEGMENT_PEN_DOWN && !isPenSettled()) {
+            return false;
+        }
+        motion_queue.pop(segment);
+        
+        switch (segment.type) {
+            case SEGMENT_PEN_UP:
+                applyPen(false);
+                break;
+                
+            case SEGMENT_PEN_DOWN:
+                applyPen(true);
+                break;
+                
+            case SEGMENT_TRAVEL:
+            case SEGMENT_DRAW:
+                applyPen(segment.type == SEGMENT_DRAW);
+                startLineMovement(segment.x, segment.y, segment.speed, segment.reverse);
+                return true;
+                
+            case SEGMENT_CURVE:
+                applyPen(true);
+                
+                // Curve starts at the previous vertex, even if tracking already curved past it
+                curve_segment = segment;
+                curve_start_x = tracking_handover ? target_x : queued_x;
+                curve_start_y = tracking_handover ? target_y : queued_y;
+                curve_t = 0.0;
+                curve_active = true;
+                if (startNextCurveChord()) {
+                    return true;
                 }
+                break;
+                
+            case SEGMENT_ARC_CW:
+            case SEGMENT_ARC_CCW:
+                applyPen(true);
+                movement_speed_mms = segment.speed;
+                tracking_movement = false;
+                tracking_handover = false;
+                planArcMovement(segment);
+                movement_scheduled = false;
+                coordinate_movement = true;
+                movement_active = true;
+                setState(MOVING);
+                return true;
+            
+            case SEGMENT_TURN: {
+                // Relative turns are not re-planned from the pose, so round the
+                // cumulative wheel targets: a run of small turns adds up exactly
+                int left_steps, right_steps;
+                kinematics.toSteps(0, floatToFixed(segment.x), left_steps, right_steps, step_remainder);
+                
+                // Set movement targets at the requested rotation rate
+                movement_speed_rad_s = segment.speed;
+                startStepMovement(left_steps, right_steps,
+                                  calculateStepInterval(left_steps, right_steps, 0.0, segment.speed));
+                setState(MOVING);
+                return true;
             }
         }
     }
+    return false;
 }
 
 /**
- * Check if current movement is complete
+ * Check if a segment needs the pen moved before it runs
  */
-bool TerraPenRobot::isMovementComplete() const {
-    return (current_left_steps == target_left_steps) && 
-           (current_right_steps == target_right_steps);
+bool TerraPenRobot::segmentChangesPen(const MotionSegment& segment) const {
+    switch (segment.type) {
+        case SEGMENT_PEN_UP:
+        case SEGMENT_TRAVEL:
+            return pen_is_down;
+        case SEGMENT_PEN_DOWN:
+        case SEGMENT_DRAW:
+        case SEGMENT_ARC_CW:
+        case SEGMENT_ARC_CCW:
+        case SEGMENT_CURVE:
+            return !pen_is_down;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Check if the pen is far enough along its sweep for motion to start
+ * Lowering must finish before drawing; a lift only has to clear the paper.
+ */
+bool TerraPenRobot::isPenSettled() const {
+    if (!pen_servo.isMoving()) {
+        return true;
+    }
+    if (pen_is_down) {
+        return false;
+    }
+    return pen_servo.getProgress() * 100 >= g_config.hardware.pen_lift_clear_percent;
+}
+
+/**
+ * Check if anything is running or waiting to run
+ */
+bool TerraPenRobot::hasPendingMotion() const {
+    // Still MOVING while the step schedule drains after the last block is queued
+    return (state == MOVING) || !motion_queue.isEmpty();
+}
+
+/**
+ * Begin a straight coordinate move to (x, y)
+ */
+void TerraPenRobot::startLineMovement(float x, float y, float speed_mms, bool reverse) {
+    // Tracking follows the line from the previous vertex if it curved through it
+    if (tracking_handover) {
+        segment_start_x = target_x;
+        segment_start_y = target_y;
+    } else {
+        segment_start_x = queued_x;
+        segment_start_y = queued_y;
+    }
+    tracking_handover = false;
+    
+    // Planned from the queued pose, which already includes every earlier
+    // step's rounding; a carried turn remainder would count it twice
+    step_remainder = StepRemainder();
+    
+    target_x = x;
+    target_y = y;
+    movement_speed_mms = speed_mms;
+    segment_reverse = reverse;
+    tracking_movement = (path_mode == PATH_TRACKING);
+    if (!tracking_movement) {
+        planCoordinateMovement();
+    }
+    movement_scheduled = false;
+    coordinate_movement = true;
+    movement_active = true;
+    setState(MOVING);
+}
+
+/**
+ * Begin the next chord of the active curve as a line movement
+ * @return false once the curve is complete
+ */
+bool TerraPenRobot::startNextCurveChord() {
+    if (curve_t >= 1.0) {
+        curve_active = false;
+        return false;
+    }
+    
+    curve_t = nextCurveParameter();
+    float x, y;
+    curvePoint(curve_t, x, y);
+    startLineMovement(x, y, curve_segment.speed);
+    return true;
+}
+
+/**
+ * Adaptive flattening step from the current curve parameter
+ * A chord over [t, t+h] deviates from the curve by at most h^2 * |B''| / 8,
+ * and B'' is linear in t, so its maximum over the chord is at an end.
+ * Steps are sized so that deviation stays within one wheel step, but never
+ * shorter than 1mm of travel so each chord is worth a movement.
+ */
+float TerraPenRobot::nextCurveParameter() const {
+    float p0x = curve_start_x, p0y = curve_start_y;
+    float p1x = curve_segment.cx, p1y = curve_segment.cy;
+    float p2x = curve_segment.c2x, p2y = curve_segment.c2y;
+    float p3x = curve_segment.x, p3y = curve_segment.y;
+    
+    // B''(t) = 6 * ((1 - t) * a + t * b)
+    float ax = p0x - 2 * p1x + p2x, ay = p0y - 2 * p1y + p2y;
+    float bx = p1x - 2 * p2x + p3x, by = p1y - 2 * p2y + p3y;
+    
+    float tolerance = PI * g_config.hardware.wheel_diameter_mm / g_config.hardware.steps_per_revolution;
+    float t = curve_t;
+    float h = 1.0 - t;
+    
+    for (uint8_t i = 0; i < 4; i++) {
+        float u = t + h;
+        float start_x = (1 - t) * ax + t * bx, start_y = (1 - t) * ay + t * by;
+        float end_x = (1 - u) * ax + u * bx, end_y = (1 - u) * ay + u * by;
+        float accel = 6.0 * max(sqrt(start_x * start_x + start_y * start_y),
+                                sqrt(end_x * end_x + end_y * end_y));
+        if (accel < 0.001) break;  // Straight over this span
+        
+        float limit = sqrt(8.0 * tolerance / accel);
+        if (h <= limit) break;
+        h = limit;
+    }
+    
+    // B'(t) = 3 * ((1 - t)^2 (p1 - p0) + 2 (1 - t) t (p2 - p1) + t^2 (p3 - p2))
+    float s = 1 - t;
+    float vx = 3 * (s * s * (p1x - p0x) + 2 * s * t * (p2x - p1x) + t * t * (p3x - p2x));
+    float vy = 3 * (s * s * (p1y - p0y) + 2 * s * t * (p2y - p1y) + t * t * (p3y - p2y));
+    float speed = sqrt(vx * vx + vy * vy);
+    if (speed > 0.001 && h * speed < 1.0) {
+        h = 1.0 / speed;
+    }
+    
+    return (t + h < 1.0) ? t + h : 1.0;
+}
+
+/**
+ * Evaluate the active curve at parameter t
+ */
+void TerraPenRobot::curvePoint(float t, float& x, float& y) const {
+    float s = 1 - t;
+    float w0 = s * s * s;
+    float w1 = 3 * s * s * t;
+    float w2 = 3 * s * t * t;
+    float w3 = t * t * t;
+    x = w0 * curve_start_x + w1 * curve_segment.cx + w2 * curve_segment.c2x + w3 * curve_segment.x;
+    y = w0 * curve_start_y + w1 * curve_segment.cy + w2 * curve_segment.c2y + w3 * curve_segment.y;
+}
+
+/**
+ * Start moving the pen servo now (motion waits for it in startNextSegment)
+ */
+void TerraPenRobot::applyPen(bool down) {
+    if (down == pen_is_down) {
+        return;  // Don't restart a sweep that is already heading there
+    }
+    
+    // Sweep over the servo's settle time so getProgress() tracks the pen
+    uint16_t angle = down ? g_config.hardware.servo_pen_down_angle : g_config.hardware.servo_pen_up_angle;
+    pen_servo.sweepTo(angle, g_config.hardware.servo_move_speed_ms);
+    pen_is_down = down;
+}
+
+/**
+ * Anchor queued planning at the current pose
+ */
+void TerraPenRobot::syncPlannedPose() {
+    // Nothing is scheduled ahead of the current pose
+    evaluatePose(queued_x, queued_y, queued_heading);
+    queued_left_steps = left_steps_total;
+    queued_right_steps = right_steps_total;
+    
+    plan_x = queued_x;
+    plan_y = queued_y;
+    plan_heading = queued_heading;
+    tracking_handover = false;
+    curve_active = false;
+}
+
+/**
+ * Set up a step-based movement relative to the current step totals
+ */
+void TerraPenRobot::startStepMovement(int left_steps, int right_steps, uint16_t interval_us) {
+    target_left_steps = left_steps;
+    target_right_steps = right_steps;
+    current_left_steps = 0;
+    current_right_steps = 0;
+    
+    // Movement starts once everything already scheduled has run
+    movement_origin_left = queued_left_steps;
+    movement_origin_right = queued_right_steps;
+    movement_interval_us = (interval_us > 0) ? interval_us : getCruiseInterval();
+    movement_scheduled = false;
+    movement_active = true;
+    coordinate_movement = false;  // Step-based movement
+}
+
+/**
+ * Hand the current movement to the step engine
+ * Steps are issued from the timer ISR, so this only fills the schedule
+ */
+void TerraPenRobot::executeMovement() {
+    if (movement_scheduled) {
+        return;  // Already in the schedule, engine is draining it
+    }
+    
+    if (queueSteps(target_left_steps, target_right_steps, movement_interval_us)) {
+        movement_scheduled = true;
+    }
+}
+
+/**
+ * Append one block to the step schedule and advance the queued pose
+ * Wheels are interpolated together, so the interval applies to the wheel
+ * with more steps and the other wheel is spread evenly across it.
+ * @return false if the schedule is full
+ */
+bool TerraPenRobot::queueSteps(int left_steps, int right_steps, uint16_t interval_us) {
+    if (!step_engine.queueBlock(left_steps, right_steps, interval_us, motion_profile)) {
+        return false;
+    }
+    
+    queued_left_steps += left_steps;
+    queued_right_steps += right_steps;
+    
+    // Record where the block ends so evaluatePose() can find it (the engine
+    // skips empty blocks, so they get no slot)
+    if (left_steps != 0 || right_steps != 0) {
+        advanceAnchor();
+        uint8_t slot = queued_blocks & (STEP_ENGINE_QUEUE_SIZE - 1);
+        block_end_left[slot] = queued_left_steps;
+        block_end_right[slot] = queued_right_steps;
+        queued_blocks++;
+    }
+    
+    // Same integration as evaluatePose() so planning and the reported pose agree
+    integratePose(queued_x, queued_y, queued_heading, left_steps, right_steps);
+    return true;
+}
+
+/**
+ * Configured interval for step-based movements, clamped to the motor timing limits
+ */
+uint16_t TerraPenRobot::getCruiseInterval() const {
+    uint16_t interval = g_config.hardware.step_delay_us;
+    if (interval < g_config.hardware.min_step_delay_us) interval = g_config.hardware.min_step_delay_us;
+    if (interval > g_config.hardware.max_step_delay_us) interval = g_config.hardware.max_step_delay_us;
+    return interval;
+}
+
+/**
+ * Pull absolute step totals from the step engine and update movement progress
+ */
+void TerraPenRobot::syncStepCounts() {
+    left_steps_total = step_engine.getLeftPosition();
+    right_steps_total = step_engine.getRightPosition();
+    
+    current_left_steps = left_steps_total - movement_origin_left;
+    current_right_steps = right_steps_total - movement_origin_right;
 }
 
 /**
  * Stop all motors immediately
+ * Goes through the step engine so an idle-hold chop cannot re-energise
+ * the coils afterwards.
  */
 void TerraPenRobot::stopAllMotors() {
-    left_motor.release();
-    right_motor.release();
+    step_engine.release();
 }
 
 /**
@@ -451,146 +1088,404 @@ void TerraPenRobot::setState(RobotState new_state) {
     state = new_state;
 }
 
+/**
+ * Re-derive the kinematic constants from g_config.hardware
+ * Called from begin() and whenever the geometry changes, never per move.
+ */
+void TerraPenRobot::rebuildKinematics() {
+    kinematics.configure(g_config.hardware.wheel_diameter_mm * g_config.hardware.left_wheel_scale,
+                         g_config.hardware.wheel_diameter_mm * g_config.hardware.right_wheel_scale,
+                         g_config.hardware.wheelbase_mm,
+                         g_config.hardware.steps_per_revolution);
+    
+    // Carried fractions are in steps of the old geometry
+    step_remainder = StepRemainder();
+}
+
+/**
+ * Check if a straight move is too short to round to any wheel steps
+ * Replaces a fixed distance tolerance, so every move that can be made is.
+ */
+bool TerraPenRobot::isWithinStep(float distance_mm) const {
+    int left_steps, right_steps;
+    return kinematics.toSteps(floatToFixed(distance_mm), 0, left_steps, right_steps) &&
+           left_steps == 0 && right_steps == 0;
+}
+
+/**
+ * Check that a movement converts to wheel steps a 16-bit count can hold
+ * Segments are checked when queued, so planning never meets one that fails.
+ */
+bool TerraPenRobot::fitsStepRange(float distance_mm, float angle_rad) const {
+    if (fabs(distance_mm) >= 32767.0 || fabs(angle_rad) >= 32767.0) {
+        return false;  // Would not even fit Q16.16
+    }
+    int left_steps, right_steps;
+    return kinematics.toSteps(floatToFixed(distance_mm), floatToFixed(angle_rad), left_steps, right_steps);
+}
+
 /**
  * Calculate motor steps needed for given distance and angle change
- * Using differential drive kinematics
+ * Using differential drive kinematics (fixed point, see KinematicModel).
+ * Out-of-range movements give zero steps; enqueueSegment() keeps them out.
  */
 void TerraPenRobot::calculateSteps(float distance_mm, float angle_diff, int& left_steps, int& right_steps) {
-    // Get hardware parameters
-    float wheel_diameter = g_config.hardware.wheel_diameter_mm;
-    float wheelbase = g_config.hardware.wheelbase_mm;
-    int steps_per_rev = g_config.hardware.steps_per_revolution;
-    
-    // Calculate wheel circumference
-    float wheel_circumference = PI * wheel_diameter;
+    // For pure rotation (distance = 0) each wheel travels angle_diff * wheelbase / 2;
+    // for pure translation (angle_diff = 0) both wheels travel the same distance
+    kinematics.toSteps(floatToFixed(distance_mm), floatToFixed(angle_diff), left_steps, right_steps);
+}
+
+/**
+ * Convert motor steps back to distance and angle change
+ * Inverse kinematics for position estimation
+ */
+void TerraPenRobot::stepsToMovement(int left_steps, int right_steps, float& distance, float& angle_change) const {
+    // Float overload: odometry sums many small movements, so skip Q16.16 rounding
+    kinematics.toMovement(left_steps, right_steps, distance, angle_change);
+}
+
+/**
+ * Convert a feedrate into the major-axis step interval for a movement
+ * The slower of the linear and angular limits sets the movement duration;
+ * pass 0 to ignore either limit.
+ */
+uint16_t TerraPenRobot::calculateStepInterval(int left_steps, int right_steps, float speed_mms, float speed_rad_s) const {
+    long major_steps = max(abs(left_steps), abs(right_steps));
+    if (major_steps == 0) {
+        return getCruiseInterval();
+    }
     
-    // For pure rotation (distance = 0):
-    // Arc length each wheel travels = angle_diff * wheelbase / 2
-    // For pure translation (angle_diff = 0):
-    // Both wheels travel the same distance
+    float distance, angle_change;
+    stepsToMovement(left_steps, right_steps, distance, angle_change);
     
-    // Calculate distance each wheel needs to travel
-    float arc_length = angle_diff * wheelbase / 2.0;
-    float left_distance = distance_mm - arc_length;   // Left wheel travels less for right turn
-    float right_distance = distance_mm + arc_length;  // Right wheel travels more for right turn
+    // Time the movement should take at the requested feedrate
+    float duration_s = 0.0;
+    if (speed_mms > 0) {
+        duration_s = fabs(distance) / speed_mms;
+    }
+    if (speed_rad_s > 0) {
+        duration_s = max(duration_s, fabs(angle_change) / speed_rad_s);
+    }
     
-    // Convert distances to steps
-    left_steps = (int)round((left_distance / wheel_circumference) * steps_per_rev);
-    right_steps = (int)round((right_distance / wheel_circumference) * steps_per_rev);
+    // Spread over the wheel with more steps, within the motor limits
+    float interval_us = (duration_s * 1000000.0) / major_steps;
+    if (interval_us < g_config.hardware.min_step_delay_us) return g_config.hardware.min_step_delay_us;
+    if (interval_us > g_config.hardware.max_step_delay_us) return g_config.hardware.max_step_delay_us;
+    return (uint16_t)interval_us;
 }
 
 /**
- * Convert motor steps back to distance and angle change
- * Inverse kinematics for position estimation
+ * Advance a pose along one block of wheel steps
+ * A fixed step ratio drives a constant-curvature arc, so the pose moves
+ * along the chord at the mean heading; exact for arcs, lines and spins.
  */
-void TerraPenRobot::stepsToMovement(int left_steps, int right_steps, float& distance, float& angle_change) {
-    // Get hardware parameters
-    float wheel_diameter = g_config.hardware.wheel_diameter_mm;
-    float wheelbase = g_config.hardware.wheelbase_mm;
-    int steps_per_rev = g_config.hardware.steps_per_revolution;
+void TerraPenRobot::integratePose(float& x, float& y, bam_t& heading, int left_steps, int right_steps) const {
+    float distance, angle_change;
+    stepsToMovement(left_steps, right_steps, distance, angle_change);
     
-    // Calculate wheel circumference
-    float wheel_circumference = PI * wheel_diameter;
+    // Chord of the arc (distance itself for straight motion)
+    float half_change = angle_change / 2.0;
+    float chord = distance;
+    if (fabs(half_change) > 1e-6) {
+        chord = distance * sin(half_change) / half_change;
+    }
     
-    // Convert steps to distances
-    float left_distance = (float(left_steps) / steps_per_rev) * wheel_circumference;
-    float right_distance = (float(right_steps) / steps_per_rev) * wheel_circumference;
+    bam_t mean_heading = heading + radiansToBam(half_change);
+    x += chord * TP_SIN_BAM(mean_heading);
+    y += chord * TP_COS_BAM(mean_heading);
     
-    // Calculate robot movement
-    distance = (left_distance + right_distance) / 2.0;  // Average distance
-    angle_change = (right_distance - left_distance) / wheelbase;  // Differential creates rotation
+    // Exact integer turn; wraps past a half turn without normalisation
+    heading += kinematics.toHeadingChange(left_steps, right_steps);
 }
 
 /**
- * Update position estimate based on step counts since last update
+ * Evaluate the current pose from the step state
+ * Nothing is integrated as steps are issued. The anchor is the pose where
+ * the oldest unretired block starts; every block retired since then and
+ * the steps issued into the active one are constant-ratio arcs from it,
+ * integrated exactly like the planner did when they were queued.
  */
-void TerraPenRobot::updatePositionEstimate() {
-    static long last_left_steps = 0;
-    static long last_right_steps = 0;
+void TerraPenRobot::evaluatePose(float& x, float& y, bam_t& heading) const {
+    uint8_t retired;
+    long left, right;
+    step_engine.getProgress(retired, left, right);
     
-    // Calculate step changes since last update
-    int delta_left = left_steps_total - last_left_steps;
-    int delta_right = right_steps_total - last_right_steps;
+    x = anchor_x;
+    y = anchor_y;
+    heading = anchor_heading;
+    long from_left = anchor_left_steps;
+    long from_right = anchor_right_steps;
+    for (uint8_t block = anchor_block; block != retired; block++) {
+        uint8_t slot = block & (STEP_ENGINE_QUEUE_SIZE - 1);
+        integratePose(x, y, heading, block_end_left[slot] - from_left, block_end_right[slot] - from_right);
+        from_left = block_end_left[slot];
+        from_right = block_end_right[slot];
+    }
     
-    // Only update if there were step changes
-    if (delta_left != 0 || delta_right != 0) {
-        float distance, angle_change;
-        stepsToMovement(delta_left, delta_right, distance, angle_change);
-        
-        // Update position based on movement in current direction
-        current_x += distance * sin(current_angle);
-        current_y += distance * cos(current_angle);
-        current_angle += angle_change;
-        
-        // Normalize angle to [-PI, PI]
-        while (current_angle > PI) current_angle -= 2 * PI;
-        while (current_angle < -PI) current_angle += 2 * PI;
-        
-        // Update step tracking
-        last_left_steps = left_steps_total;
-        last_right_steps = right_steps_total;
+    // Part way through the active block
+    if (left != from_left || right != from_right) {
+        integratePose(x, y, heading, left - from_left, right - from_right);
     }
 }
 
 /**
- * Execute coordinate-based movement
+ * Move the anchor past blocks the step engine has retired
+ * Must run before a new block reuses a retired block's slot.
  */
-void TerraPenRobot::executeCoordinateMovement() {
+void TerraPenRobot::advanceAnchor() {
+    uint8_t retired;
+    long left, right;
+    step_engine.getProgress(retired, left, right);
+    
+    for (; anchor_block != retired; anchor_block++) {
+        uint8_t slot = anchor_block & (STEP_ENGINE_QUEUE_SIZE - 1);
+        integratePose(anchor_x, anchor_y, anchor_heading,
+                      block_end_left[slot] - anchor_left_steps, block_end_right[slot] - anchor_right_steps);
+        anchor_left_steps = block_end_left[slot];
+        anchor_right_steps = block_end_right[slot];
+    }
+}
+
+/**
+ * Anchor at the current pose and forget the scheduled blocks
+ * Only valid once the step engine is stopped or idle.
+ */
+void TerraPenRobot::rebaseAnchor() {
+    float x, y;
+    bam_t heading;
+    evaluatePose(x, y, heading);
+    
+    uint8_t retired;
+    step_engine.getProgress(retired, anchor_left_steps, anchor_right_steps);
+    anchor_x = x;
+    anchor_y = y;
+    anchor_heading = heading;
+    anchor_block = retired;
+    queued_blocks = retired;
+}
+
+/**
+ * Plan a coordinate move as one rotation and one straight run
+ * Runs once when the move starts, from the queued pose (where the robot
+ * will be after everything already scheduled), so the float work happens
+ * once per move rather than once per step.
+ */
+void TerraPenRobot::planCoordinateMovement() {
     // Calculate distance and angle to target
-    float dx = target_x - current_x;
-    float dy = target_y - current_y;
+    float dx = target_x - queued_x;
+    float dy = target_y - queued_y;
     float distance_to_target = sqrt(dx * dx + dy * dy);
     
-    // Check if we're close enough to target (within 0.5mm)
-    if (distance_to_target < 0.5) {
-        return;  // Close enough, movement will complete
+    segment_turn_left = 0;
+    segment_turn_right = 0;
+    segment_run_left = 0;
+    segment_run_right = 0;
+    segment_turn_queued = false;
+    
+    // Already there (closer than one step) - keep the current heading
+    if (isWithinStep(distance_to_target)) {
+        return;
     }
     
-    // Calculate required angle to target
-    float required_angle = atan2(dx, dy);
-    float angle_diff = required_angle - current_angle;
+    // Calculate required angle to target (facing away when backing up)
+    bam_t required_heading = radiansToBam(TP_ATAN2(dx, dy)) + (segment_reverse ? BAM_HALF_TURN : 0);
+    float angle_diff = bamToRadians(required_heading - queued_heading);  // Shortest turn
     
-    // Normalize angle difference to [-PI, PI]
-    while (angle_diff > PI) angle_diff -= 2 * PI;
-    while (angle_diff < -PI) angle_diff += 2 * PI;
+    // Rotate with the wheel rims at the linear feedrate
+    calculateSteps(0.0, angle_diff, segment_turn_left, segment_turn_right);
+    float speed_rad_s = 2.0 * movement_speed_mms / g_config.hardware.wheelbase_mm;
+    segment_turn_interval_us = calculateStepInterval(segment_turn_left, segment_turn_right, 0.0, speed_rad_s);
     
-    // If we need to turn significantly (> 5 degrees), turn first
-    if (abs(angle_diff) > 0.087) {  // 5 degrees in radians
-        // Calculate steps for pure rotation
-        int left_steps, right_steps;
-        calculateSteps(0.0, angle_diff, left_steps, right_steps);
+    // Then drive straight at the requested feedrate
+    calculateSteps(segment_reverse ? -distance_to_target : distance_to_target, 0.0,
+                   segment_run_left, segment_run_right);
+    segment_run_interval_us = calculateStepInterval(segment_run_left, segment_run_right,
+                                                    movement_speed_mms, 0.0);
+}
+
+/**
+ * Plan an arc as a rotation onto the tangent and one constant-ratio block
+ * The radius comes from the queued pose, so the arc starts exactly where
+ * the previous motion ends.
+ */
+void TerraPenRobot::planArcMovement(const MotionSegment& segment) {
+    bool clockwise = (segment.type == SEGMENT_ARC_CW);
+    float dx = queued_x - segment.cx;
+    float dy = queued_y - segment.cy;
+    float radius = sqrt(dx * dx + dy * dy);
+    
+    // Bearings from the centre (same convention as headings)
+    bam_t start_bearing = radiansToBam(TP_ATAN2(dx, dy));
+    bam_t end_bearing = radiansToBam(TP_ATAN2(segment.x - segment.cx, segment.y - segment.cy));
+    
+    // Clockwise sweeps increase the bearing; an end on the start point is a full circle
+    float sweep;
+    if (clockwise) {
+        sweep = bamToPositiveRadians(end_bearing - start_bearing);
+        if (sweep * radius < 0.5) sweep += 2 * PI;
+    } else {
+        sweep = -bamToPositiveRadians(start_bearing - end_bearing);
+        if (-sweep * radius < 0.5) sweep -= 2 * PI;
+    }
+    
+    // Turn onto the tangent first
+    bam_t tangent = start_bearing + (clockwise ? BAM_QUARTER_TURN : -BAM_QUARTER_TURN);
+    float angle_diff = bamToRadians(tangent - queued_heading);
+    
+    calculateSteps(0.0, angle_diff, segment_turn_left, segment_turn_right);
+    float speed_rad_s = 2.0 * movement_speed_mms / g_config.hardware.wheelbase_mm;
+    segment_turn_interval_us = calculateStepInterval(segment_turn_left, segment_turn_right, 0.0, speed_rad_s);
+    segment_turn_queued = false;
+    
+    // Heading turns with the bearing, so the wheels hold a fixed ratio for the whole arc
+    calculateSteps(radius * fabs(sweep), sweep, segment_run_left, segment_run_right);
+    segment_run_interval_us = calculateStepInterval(segment_run_left, segment_run_right,
+                                                    movement_speed_mms, 0.0);
+    
+    target_x = segment.cx + radius * TP_SIN_BAM(end_bearing);
+    target_y = segment.cy + radius * TP_COS_BAM(end_bearing);
+    step_remainder = StepRemainder();  // Planned from the queued pose, see startLineMovement()
+}
+
+/**
+ * Execute coordinate-based movement
+ * Pure integer dispatch of the planned blocks; retries next update if the
+ * step schedule is full.
+ */
+void TerraPenRobot::executeCoordinateMovement() {
+    if (!segment_turn_queued) {
+        if ((segment_turn_left != 0 || segment_turn_right != 0) &&
+            !queueSteps(segment_turn_left, segment_turn_right, segment_turn_interval_us)) {
+            return;
+        }
+        segment_turn_queued = true;
+    }
+    
+    if ((segment_run_left != 0 || segment_run_right != 0) &&
+        !queueSteps(segment_run_left, segment_run_right, segment_run_interval_us)) {
+        return;
+    }
+    movement_scheduled = true;
+}
+
+/**
+ * Follow the active line segment with pure pursuit
+ * Each block is a short arc through a point one lookahead distance further
+ * along the line, so heading changes are spread over the path instead of
+ * being made with the robot stopped.
+ */
+void TerraPenRobot::executeTrackingMovement() {
+    float lookahead = g_config.hardware.tracking_lookahead_mm;
+    
+    while (step_engine.getFreeSlots() > 0) {
+        float dx = target_x - queued_x;
+        float dy = target_y - queued_y;
+        float distance_to_target = sqrt(dx * dx + dy * dy);
         
-        // Set rotation targets
-        target_left_steps = left_steps;
-        target_right_steps = right_steps;
-        current_left_steps = 0;
-        current_right_steps = 0;
+        // Hand over early so the robot curves through the vertex into the next segment
+        if (distance_to_target < lookahead && continuesSmoothly()) {
+            tracking_handover = true;
+            movement_scheduled = true;
+            return;
+        }
+        
+        // Closer than one step - the target has been reached
+        if (isWithinStep(distance_to_target)) {
+            movement_scheduled = true;
+            return;
+        }
+        
+        // Lookahead point: project onto the line and move one lookahead distance along it
+        float line_dx = target_x - segment_start_x;
+        float line_dy = target_y - segment_start_y;
+        float line_length = sqrt(line_dx * line_dx + line_dy * line_dy);
+        float look_x = target_x;
+        float look_y = target_y;
+        bool final_block = true;   // Lookahead point is the target itself
+        if (line_length > 0.001) {
+            float along = ((queued_x - segment_start_x) * line_dx +
+                           (queued_y - segment_start_y) * line_dy) / line_length + lookahead;
+            if (along < line_length) {
+                look_x = segment_start_x + line_dx * along / line_length;
+                look_y = segment_start_y + line_dy * along / line_length;
+                final_block = false;
+            }
+        }
+        
+        float look_dx = look_x - queued_x;
+        float look_dy = look_y - queued_y;
+        float look_distance = sqrt(look_dx * look_dx + look_dy * look_dy);
+        
+        // Backing up steers the rear of the robot, which faces opposite the heading
+        bam_t travel_heading = queued_heading + (segment_reverse ? BAM_HALF_TURN : 0);
+        float alpha = bamToRadians(radiansToBam(TP_ATAN2(look_dx, look_dy)) - travel_heading);
         
-        // Execute step-based movement
-        executeMovement();
-    } else {
-        // Move forward toward target
-        float step_distance = min(distance_to_target, 1.0);  // Max 1mm per step
         int left_steps, right_steps;
-        calculateSteps(step_distance, 0.0, left_steps, right_steps);
+        uint16_t interval_us;
+        
+        if (fabs(alpha) > g_config.hardware.tracking_corner_rad) {
+            // Too sharp to steer through - turn in place toward the lookahead point
+            calculateSteps(0.0, alpha, left_steps, right_steps);
+            float speed_rad_s = 2.0 * movement_speed_mms / g_config.hardware.wheelbase_mm;
+            interval_us = calculateStepInterval(left_steps, right_steps, 0.0, speed_rad_s);
+        } else {
+            // Arc through the lookahead point: curvature = 2 sin(alpha) / distance
+            float arc_length = min(look_distance, lookahead / 2.0);
+            if (final_block) {
+                // Whole arc to the target in one block, so it ends on the target
+                // instead of closing in on it
+                arc_length = (fabs(alpha) > 1e-4) ? look_distance * alpha / TP_SIN(alpha) : look_distance;
+            }
+            float angle_change = 2.0 * TP_SIN(alpha) / look_distance * arc_length;
+            calculateSteps(segment_reverse ? -arc_length : arc_length, angle_change, left_steps, right_steps);
+            interval_us = calculateStepInterval(left_steps, right_steps, movement_speed_mms, 0.0);
+        }
         
-        // Set movement targets
-        target_left_steps = left_steps;
-        target_right_steps = right_steps;
-        current_left_steps = 0;
-        current_right_steps = 0;
+        // Below one step of resolution - nothing more to schedule
+        if (left_steps == 0 && right_steps == 0) {
+            movement_scheduled = true;
+            return;
+        }
         
-        // Execute step-based movement
-        executeMovement();
+        if (!queueSteps(left_steps, right_steps, interval_us)) {
+            return;  // Schedule full, continue next update
+        }
+        if (final_block && fabs(alpha) <= g_config.hardware.tracking_corner_rad) {
+            movement_scheduled = true;
+            return;
+        }
     }
 }
 
 /**
- * Check if robot is at target coordinates
+ * Check if the next queued segment continues the tracked line gently
+ * It must be a line with the same pen state that bends by no more than
+ * tracking_corner_rad; sharper corners are driven to and turned in place.
  */
-bool TerraPenRobot::isAtTargetPosition() const {
-    float dx = target_x - current_x;
-    float dy = target_y - current_y;
-    float distance = sqrt(dx * dx + dy * dy);
-    return distance < 0.5;  // Within 0.5mm tolerance
-}
\ No newline at end of file
+bool TerraPenRobot::continuesSmoothly() const {
+    if (path_mode != PATH_TRACKING) {
+        return false;
+    }
+    
+    // Next vertex: the next chord of the active curve, or the next queued segment
+    float next_x, next_y;
+    const MotionSegment* next = motion_queue.peek();
+    if (curve_active && curve_t < 1.0) {
+        curvePoint(nextCurveParameter(), next_x, next_y);
+    } else if (next != nullptr && next->type == (pen_is_down ? SEGMENT_DRAW : SEGMENT_TRAVEL) &&
+               next->reverse == segment_reverse) {
+        next_x = next->x;
+        next_y = next->y;
+    } else if (next != nullptr && next->type == SEGMENT_CURVE && pen_is_down && !segment_reverse) {
+        // Curve leaves toward its first control point (second if they coincide)
+        bool degenerate = fabs(next->cx - target_x) < 0.01 && fabs(next->cy - target_y) < 0.01;
+        next_x = degenerate ? next->c2x : next->cx;
+        next_y = degenerate ? next->c2y : next->cy;
+    } else {
+        return false;
+    }
+    
+    bam_t bend = radiansToBam(TP_ATAN2(next_x - target_x, next_y - target_y)) -
+                 radiansToBam(TP_ATAN2(target_x - segment_start_x, target_y - segment_start_y));
+    return bamMagnitude(bend) <= radiansToBam(g_config.hardware.tracking_corner_rad);
+}
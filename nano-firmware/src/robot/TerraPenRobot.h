@@ -4,6 +4,9 @@
 #include <Arduino.h>
 #include "../hardware/StepperDriver.h"
 #include "../hardware/ServoDriver.h"
+#include "../hardware/StepEngine.h"
+#include "MotionQueue.h"
+#include "KinematicModel.h"
 #include "../TerraPenConfig.h"
 #include "../Position.h"
 
@@ -17,6 +20,23 @@ enum RobotState {
     EMERGENCY_STOP  // Emergency stop engaged
 };
 
+/**
+ * How moveTo/drawTo segments are followed
+ */
+enum PathMode : uint8_t {
+    PATH_SPOT_TURN = 0,  // Stop, turn in place, drive straight
+    PATH_TRACKING = 1    // Steer along the path with continuous curvature
+};
+
+/**
+ * When moveTo/drawTo may drive backward instead of spinning to face the target
+ */
+enum ReverseMode : uint8_t {
+    REVERSE_NEVER = 0,   // Always turn to face the target
+    REVERSE_TRAVEL = 1,  // Pen-up travel only
+    REVERSE_ALWAYS = 2   // Travel and drawing (pen centred between the wheels)
+};
+
 /**
  * TerraPenRobot - Phase 1.5 Implementation
  * 
@@ -37,21 +57,28 @@ private:
     StepperDriver left_motor;
     StepperDriver right_motor;
     ServoDriver pen_servo;
+    StepEngine step_engine;     // Timer-driven step generation
     
     // Robot state
     RobotState state;
     bool pen_is_down;
     
-    // Position tracking (Phase 2)
-    float current_x;           // Current X position in mm
-    float current_y;           // Current Y position in mm  
-    float current_angle;       // Current orientation in radians
+    // Position tracking (Phase 2) - kept in step space, x/y/heading evaluated on demand
+    float anchor_x;            // Pose where the oldest unretired step block starts
+    float anchor_y;
+    bam_t anchor_heading;
+    long anchor_left_steps;    // Step totals at the anchor pose
+    long anchor_right_steps;
+    uint8_t anchor_block;      // Step engine retired-block count at the anchor pose
     
     // Movement coordination state
     int target_left_steps;
     int target_right_steps;
     int current_left_steps;
     int current_right_steps;
+    long movement_origin_left;  // Step totals when the current movement starts running
+    long movement_origin_right;
+    bool movement_scheduled;    // True once all of the movement is in the step schedule
     bool movement_active;
     
     // Coordinate movement state (Phase 2)
@@ -59,20 +86,81 @@ private:
     float target_y;           // Target Y position for coordinate moves
     bool coordinate_movement; // True if executing coordinate-based movement
     float movement_speed_mms; // Movement speed in mm/s
+    float movement_speed_rad_s; // Rotation speed in rad/s for turnBy/turnTo
+    uint16_t movement_interval_us; // Major-axis step interval for the active movement
+    
+    // Rotate-then-translate plan for the active coordinate move (set once per move)
+    int segment_turn_left;     // Rotation block steps
+    int segment_turn_right;
+    uint16_t segment_turn_interval_us;
+    int segment_run_left;      // Straight or arc block steps
+    int segment_run_right;
+    uint16_t segment_run_interval_us;
+    bool segment_turn_queued;
+    
+    // Pure-pursuit tracking of the active line segment
+    bool tracking_movement;    // True if the active coordinate move is tracked
+    bool tracking_handover;    // Left the previous segment early to curve through its end
+    float segment_start_x;     // Start of the line being tracked
+    float segment_start_y;
+    bool segment_reverse;      // Active line is driven backward
+    
+    // Cubic Bezier being flattened (next chord is generated when the previous one is planned)
+    MotionSegment curve_segment; // Control points, end point and speed
+    float curve_start_x;       // Curve start point
+    float curve_start_y;
+    float curve_t;             // Curve parameter reached by the chords so far
+    bool curve_active;
+    
+    // Queued motion (segments waiting behind the active movement)
+    MotionQueue motion_queue;
+    float plan_x;             // Pose at the end of all queued motion,
+    float plan_y;             // used to chain relative and heading moves
+    bam_t plan_heading;
+    
+    // Step schedule look-ahead (where the robot is once all queued blocks have run)
+    long queued_left_steps;
+    long queued_right_steps;
+    StepRemainder step_remainder; // Sub-step part of the exact wheel targets beyond queued_*_steps
+    float queued_x;
+    float queued_y;
+    bam_t queued_heading;
+    MotionProfile motion_profile; // Velocity profile for new movements
+    PathMode path_mode;         // Path following for new coordinate moves
+    ReverseMode reverse_mode;   // Backward driving for new coordinate moves
+    
+    // Wheel geometry, rebuilt from g_config.hardware only when it changes
+    KinematicModel kinematics;
     
     // Step counting for position tracking
     long left_steps_total;
     long right_steps_total;
     
+    // Step totals at the end of each block in the step engine schedule
+    long block_end_left[STEP_ENGINE_QUEUE_SIZE];
+    long block_end_right[STEP_ENGINE_QUEUE_SIZE];
+    uint8_t queued_blocks;     // Blocks handed to the step engine (wraps like its retired count)
+    
 public:
     // === INITIALIZATION ===
     void begin();  // Uses g_config.hardware
     
     // === COORDINATE-BASED MOVEMENT (Phase 2) ===
-    bool moveTo(float x, float y, float speed_mms = 15.0);     // Move to coordinates with pen up
-    bool drawTo(float x, float y, float speed_mms = 10.0);     // Draw line to coordinates with pen down
-    bool moveBy(float dx, float dy, float speed_mms = 15.0);   // Move relative to current position
-    bool drawBy(float dx, float dy, float speed_mms = 10.0);   // Draw relative to current position
+    // Movements are queued behind any active motion; false means invalid or queue full.
+    // Speeds default to g_config.getCruiseSpeedMms() (one step per step_delay_us).
+    bool moveTo(float x, float y, float speed_mms = g_config.getCruiseSpeedMms());   // Move to coordinates with pen up
+    bool drawTo(float x, float y, float speed_mms = g_config.getCruiseSpeedMms());   // Draw line to coordinates with pen down
+    bool moveBy(float dx, float dy, float speed_mms = g_config.getCruiseSpeedMms()); // Move relative to current position
+    bool drawBy(float dx, float dy, float speed_mms = g_config.getCruiseSpeedMms()); // Draw relative to current position
+    
+    // === ARCS ===
+    // One constant-curvature movement with a fixed left/right step ratio
+    bool arcTo(float cx, float cy, float x, float y, bool clockwise, float speed_mms = g_config.getCruiseSpeedMms()); // Draw arc around (cx, cy)
+    bool circle(float radius, bool clockwise = true, float speed_mms = g_config.getCruiseSpeedMms()); // Draw full circle tangent to current heading
+    
+    // === CURVES ===
+    // Flattened on the robot into chords within one step of the true curve
+    bool curveTo(float c1x, float c1y, float c2x, float c2y, float x, float y, float speed_mms = g_config.getCruiseSpeedMms()); // Draw cubic Bezier
     
     // === ROTATION CONTROL (Phase 2) ===
     bool turnTo(float angle_radians, float speed_rad_s = 0.5); // Turn to absolute angle
@@ -84,8 +172,29 @@ public:
     bool turnLeft(int steps);        // Returns false if busy
     bool turnRight(int steps);       // Returns false if busy
     
+    // === MOTION PROFILE ===
+    void setMotionProfile(MotionProfile profile); // Applies to movements started afterwards
+    MotionProfile getMotionProfile() const;
+    
+    // === PATH MODE ===
+    void setPathMode(PathMode mode); // Applies to moveTo/drawTo segments started afterwards
+    PathMode getPathMode() const;
+    void setReverseMode(ReverseMode mode); // Applies to moveTo/drawTo queued afterwards
+    ReverseMode getReverseMode() const;
+    
+    // === CALIBRATION ===
+    bool setGeometry(float left_diameter_mm, float right_diameter_mm, float wheelbase_mm); // Effective wheel sizes; false if moving or invalid
+    const KinematicModel& getKinematics() const;
+    
+    // === POWER ===
+    void setIdleHold(uint8_t percent); // Coil hold current while stopped (% of full), restored when motion resumes
+    
+    // === MOTION QUEUE ===
+    uint8_t getFreeSlots() const;    // Segments that can be queued right now
+    void clearQueue();               // Drop queued segments (active movement continues)
+    
     // === PEN CONTROL ===
-    void penUp();
+    void penUp();                    // Queued behind active motion, otherwise immediate
     void penDown();
     bool isPenDown() const;
     
@@ -97,33 +206,59 @@ public:
     
     // === POSITION TRACKING (Phase 2) ===
     Position getCurrentPosition() const;    // Get current position and orientation
-    void resetPosition(float x = 0, float y = 0, float angle = 0); // Reset position tracking
-    bool isAtTarget() const;                // Check if at target position
+    bool resetPosition(float x = 0, float y = 0, float angle = 0); // Reset position tracking (false while moving)
+    bool isAtTarget() const;                // Every step planned so far has been issued
     
     // === WORKSPACE SAFETY (Phase 2) ===
     bool isValidPosition(float x, float y) const; // Check workspace boundaries
+    bool isValidArc(float cx, float cy, float x, float y, bool clockwise) const; // Whole arc from the queued end point stays inside
     
     // === STEP TRACKING (for Phase 2) ===
     long getLeftStepsTotal() const;
     long getRightStepsTotal() const;
-    void resetStepCounts();
+    bool resetStepCounts();          // Zero the step totals (false while moving)
     
     // === UPDATE FUNCTION ===
     void update();                   // Call every loop iteration - coordinates drivers
     
 private:
     // === INTERNAL METHODS ===
-    void executeMovement();          // Coordinate stepForward/stepBackward calls
+    void startStepMovement(int left_steps, int right_steps, uint16_t interval_us = 0); // Set up a step-based movement (0 = configured rate)
+    void executeMovement();          // Fill the step engine schedule
+    bool queueSteps(int left_steps, int right_steps, uint16_t interval_us); // Schedule one block, advance queued pose
+    void syncStepCounts();           // Pull step totals from the step engine
+    void rebuildKinematics();        // Re-derive conversion constants from g_config.hardware
+    uint16_t getCruiseInterval() const; // Configured step interval within hardware limits
     void setState(RobotState new_state);
-    bool isMovementComplete() const;
+    bool enqueueSegment(uint8_t type, float x, float y, float speed, float cx = 0.0, float cy = 0.0,
+                        float c2x = 0.0, float c2y = 0.0); // Append and start if idle
+    void startLineMovement(float x, float y, float speed_mms, bool reverse = false); // Begin a straight coordinate move
+    bool startNextCurveChord();      // Begin the next chord of the active curve
+    float nextCurveParameter() const; // Parameter at the end of the next chord
+    void curvePoint(float t, float& x, float& y) const; // Point on the active curve
+    bool startNextSegment();         // Begin the next queued movement, false if none
+    bool hasPendingMotion() const;   // Active movement or queued segments
+    void applyPen(bool down);        // Move the pen servo now
+    void syncPlannedPose();          // Re-anchor queued planning at the current pose
+    bool isWithinStep(float distance_mm) const; // Too short to round to any wheel steps
+    bool fitsStepRange(float distance_mm, float angle_rad) const; // Converts to wheel steps without overflow
+    bool segmentChangesPen(const MotionSegment& segment) const; // Pen must move before this segment runs
+    bool isPenSettled() const;       // Pen is far enough along for motion to start
     void stopAllMotors();
     
     // === KINEMATICS CALCULATIONS (Phase 2) ===
     void calculateSteps(float distance_mm, float angle_diff, int& left_steps, int& right_steps);
-    void stepsToMovement(int left_steps, int right_steps, float& distance, float& angle_change);
-    void updatePositionEstimate();   // Update position based on step counts
+    void stepsToMovement(int left_steps, int right_steps, float& distance, float& angle_change) const;
+    uint16_t calculateStepInterval(int left_steps, int right_steps, float speed_mms, float speed_rad_s) const;
+    void integratePose(float& x, float& y, bam_t& heading, int left_steps, int right_steps) const; // Advance a pose along a block
+    void evaluatePose(float& x, float& y, bam_t& heading) const; // Current pose from the step state
+    void advanceAnchor();            // Fold retired blocks into the anchor pose
+    void rebaseAnchor();             // Anchor at the current pose with nothing scheduled (engine stopped)
+    void planCoordinateMovement();   // Plan rotate-then-translate from the queued pose
+    void planArcMovement(const MotionSegment& segment); // Plan rotate-to-tangent then arc from the queued pose
     void executeCoordinateMovement(); // Execute coordinate-based movement
-    bool isAtTargetPosition() const;       // Check if at target coordinates
+    void executeTrackingMovement();  // Pure-pursuit arcs along the active segment
+    bool continuesSmoothly() const;  // Next segment can be curved into without stopping
 };
 
 #endif // TERRAPEN_ROBOT_H
\ No newline at end of file
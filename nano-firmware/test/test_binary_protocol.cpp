@@ -0,0 +1,180 @@
+#include <Arduino.h>
+#include <communication/BinaryProtocol.h>
+
+// Test counter and results
+int total_tests = 0;
+int passed_tests = 0;
+
+void runTest(const char* test_name, bool condition) {
+    total_tests++;
+    Serial.print("Test: ");
+    Serial.print(test_name);
+    Serial.print(" ... ");
+    if (condition) {
+        passed_tests++;
+        Serial.println("✓ PASS");
+    } else {
+        Serial.println("✗ FAIL");
+    }
+}
+
+/**
+ * Collects what sendFrame() writes instead of sending it
+ */
+class FrameCapture : public Print {
+public:
+    uint8_t bytes[BINARY_FRAME_ENCODED_MAX + 2];
+    uint8_t length;
+    
+    FrameCapture() : length(0) {}
+    
+    size_t write(uint8_t byte) override {
+        if (length >= sizeof(bytes)) return 0;
+        bytes[length++] = byte;
+        return 1;
+    }
+    using Print::write;
+};
+
+uint8_t encoded[256];
+uint8_t decoded[256];
+
+/**
+ * Encode, check that no zero byte is left, decode in place and compare
+ */
+bool roundTrip(const uint8_t* data, uint8_t length, uint8_t expected_encoded_length) {
+    uint8_t encoded_length = cobsEncode(data, length, encoded);
+    if (encoded_length != expected_encoded_length) return false;
+    for (uint8_t i = 0; i < encoded_length; i++) {
+        if (encoded[i] == 0) return false;
+    }
+    
+    memcpy(decoded, encoded, encoded_length);
+    return cobsDecode(decoded, encoded_length) == length && memcmp(decoded, data, length) == 0;
+}
+
+void setup() {
+    Serial.begin(9600);
+    delay(2000);
+    
+    Serial.println("=== TerraPen Motion Control - Binary Protocol Tests ===");
+    
+    // === CRC16 ===
+    Serial.println("\n--- CRC16-CCITT ---");
+    
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    runTest("Check value of \"123456789\" is 0x29B1", crc16(check, sizeof(check)) == 0x29B1);
+    runTest("Empty message keeps the 0xFFFF init", crc16(check, 0) == 0xFFFF);
+    
+    uint8_t flipped[sizeof(check)];
+    memcpy(flipped, check, sizeof(check));
+    flipped[4] ^= 0x01;
+    runTest("Single bit error changes the CRC", crc16(flipped, sizeof(flipped)) != 0x29B1);
+    
+    // === COBS ===
+    Serial.println("\n--- COBS Round Trips ---");
+    
+    const uint8_t single_zero[] = {0x00};
+    runTest("Single zero", roundTrip(single_zero, sizeof(single_zero), 2));
+    
+    const uint8_t zero_run[] = {0x00, 0x00, 0x00, 0x00};
+    runTest("Run of zeros", roundTrip(zero_run, sizeof(zero_run), 5));
+    
+    const uint8_t mixed[] = {0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+    runTest("Zeros between and after data", roundTrip(mixed, sizeof(mixed), 7));
+    
+    const uint8_t no_zeros[] = {0x01, 0x02, 0x03};
+    runTest("No zeros", roundTrip(no_zeros, sizeof(no_zeros), 4));
+    
+    // 254 non-zero bytes fill one block exactly (code 0xFF, no trailing block)
+    uint8_t group[254];
+    for (uint8_t i = 0; i < sizeof(group); i++) {
+        group[i] = i + 1;
+    }
+    runTest("Full 254-byte group", roundTrip(group, 254, 255) && encoded[0] == 0xFF);
+    
+    // One short of a full group, then a zero
+    group[253] = 0x00;
+    runTest("253 bytes then a zero", roundTrip(group, 254, 255));
+    
+    // A long run broken by a zero
+    for (uint8_t i = 0; i < 200; i++) {
+        group[i] = 0x5A;
+    }
+    group[100] = 0x00;
+    runTest("Zero inside a long run", roundTrip(group, 200, 201));
+    
+    // === FRAMES ===
+    Serial.println("\n--- Frames ---");
+    
+    // MOVE_TO (12.34, -5.00) with the optional speed; payload holds zero bytes
+    uint8_t message[7];
+    message[0] = BIN_MOVE_TO;
+    writeInt16LE(message + 1, mmToBinary(12.34));
+    writeInt16LE(message + 3, mmToBinary(-5.0));
+    writeUint16LE(message + 5, 0x0100);
+    
+    FrameCapture port;
+    sendFrame(port, message, sizeof(message));
+    bool delimited = port.length > 2 && port.bytes[0] == 0x00 && port.bytes[port.length - 1] == 0x00;
+    bool clean = true;
+    for (uint8_t i = 1; i + 1 < port.length; i++) {
+        clean = clean && port.bytes[i] != 0x00;
+    }
+    runTest("Frame is delimited by zeros only", delimited && clean);
+    
+    // The reader hands over the bytes between the delimiters
+    uint8_t frame[BINARY_FRAME_ENCODED_MAX];
+    uint8_t frame_length = port.length - 2;
+    memcpy(frame, port.bytes + 1, frame_length);
+    bool unpacked = unpackFrame(frame, frame_length);
+    runTest("Good frame unpacks", unpacked && frame_length == sizeof(message) && memcmp(frame, message, sizeof(message)) == 0);
+    runTest("Payload fields read back",
+            readInt16LE(frame + 1) == 1234 && readInt16LE(frame + 3) == -500 && readUint16LE(frame + 5) == 0x0100);
+    runTest("Payload length is valid for the opcode", binaryPayloadValid(frame[0], frame_length - 1));
+    runTest("ARC_TO takes an optional speed",
+            binaryPayloadValid(BIN_ARC_TO, 9) && binaryPayloadValid(BIN_ARC_TO, 11) && !binaryPayloadValid(BIN_ARC_TO, 10));
+    runTest("CURVE_TO takes an optional speed",
+            binaryPayloadValid(BIN_CURVE_TO, 12) && binaryPayloadValid(BIN_CURVE_TO, 14) && !binaryPayloadValid(BIN_CURVE_TO, 13));
+    
+    // Corrupt one payload byte (never to zero, so the framing still holds)
+    frame_length = port.length - 2;
+    memcpy(frame, port.bytes + 1, frame_length);
+    frame[2] ^= 0x40;
+    if (frame[2] == 0x00) frame[2] = 0x40;
+    runTest("Bad CRC is rejected", !unpackFrame(frame, frame_length));
+    
+    // Lose the last bytes: the final block claims more data than arrived
+    frame_length = port.length - 4;
+    memcpy(frame, port.bytes + 1, frame_length);
+    runTest("Truncated frame is rejected", !unpackFrame(frame, frame_length));
+    
+    // Too short to hold an opcode and a CRC
+    uint8_t stub[] = {0x02, 0x07};
+    uint8_t stub_length = sizeof(stub);
+    runTest("Frame without room for a CRC is rejected", !unpackFrame(stub, stub_length));
+    
+    // A code byte pointing past the end is malformed
+    uint8_t overrun[] = {0x05, 0x01, 0x02};
+    runTest("Code past the end decodes to nothing", cobsDecode(overrun, sizeof(overrun)) == 0);
+    
+    // === SUMMARY ===
+    Serial.println();
+    Serial.print("Total Tests: ");
+    Serial.println(total_tests);
+    Serial.print("Passed: ");
+    Serial.println(passed_tests);
+    Serial.print("Failed: ");
+    Serial.println(total_tests - passed_tests);
+    
+    if (passed_tests == total_tests) {
+        Serial.println("\n🎉 ALL TESTS PASSED!");
+    } else {
+        Serial.println("\n⚠️  SOME TESTS FAILED!");
+    }
+}
+
+void loop() {
+    // Tests run once in setup(), nothing in loop
+    delay(10000);
+}
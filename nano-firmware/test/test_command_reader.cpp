@@ -0,0 +1,160 @@
+#include <Arduino.h>
+#include <communication/CommandReader.h>
+
+// Test counter and results
+int total_tests = 0;
+int passed_tests = 0;
+
+void runTest(const char* test_name, bool condition) {
+    total_tests++;
+    Serial.print("Test: ");
+    Serial.print(test_name);
+    Serial.print(" ... ");
+    if (condition) {
+        passed_tests++;
+        Serial.println("✓ PASS");
+    } else {
+        Serial.println("✗ FAIL");
+    }
+}
+
+/**
+ * Stream that plays back prepared bytes, standing in for the UART
+ */
+class ScriptedStream : public Stream {
+private:
+    uint8_t data[320];
+    uint16_t length;
+    uint16_t position;
+    
+public:
+    ScriptedStream() : length(0), position(0) {}
+    
+    void feed(const uint8_t* bytes, uint16_t count) {
+        // Start over once everything fed so far has been read
+        if (position == length) {
+            position = 0;
+            length = 0;
+        }
+        for (uint16_t i = 0; i < count && length < sizeof(data); i++) {
+            data[length++] = bytes[i];
+        }
+    }
+    
+    void feed(const char* text) {
+        feed((const uint8_t*)text, strlen(text));
+    }
+    
+    void feedRepeated(uint8_t byte, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++) {
+            feed(&byte, 1);
+        }
+    }
+    
+    int available() override { return length - position; }
+    int read() override { return position < length ? data[position++] : -1; }
+    int peek() override { return position < length ? data[position] : -1; }
+    size_t write(uint8_t) override { return 0; }
+};
+
+void setup() {
+    Serial.begin(9600);
+    delay(2000);
+    
+    Serial.println("=== TerraPen Motion Control - Command Reader Tests ===");
+    
+    // === JSON LINES ===
+    Serial.println("\n--- JSON Lines ---");
+    
+    CommandReader reader;
+    ScriptedStream port;
+    runTest("Empty port is pending", reader.read(port) == READ_PENDING);
+    
+    port.feed("{\"cmd\":7}\r\n");
+    runTest("Line is returned", reader.read(port) == READ_LINE);
+    runTest("Line is NUL-terminated without its ending",
+            strcmp(reader.line(), "{\"cmd\":7}") == 0 && reader.size() == 9);
+    runTest("CRLF does not produce an empty line", reader.read(port) == READ_PENDING);
+    
+    // A line split across reads is completed by the next bytes
+    port.feed("{\"cmd\":");
+    runTest("Partial line is pending", reader.read(port) == READ_PENDING);
+    port.feed("4}\n");
+    runTest("Line completes on a later read",
+            reader.read(port) == READ_LINE && strcmp(reader.line(), "{\"cmd\":4}") == 0);
+    
+    // Longest line that fits leaves room for the terminator
+    port.feedRepeated('a', COMMAND_READER_SIZE - 1);
+    port.feed("\n");
+    runTest("Line of COMMAND_READER_SIZE - 1 bytes fits",
+            reader.read(port) == READ_LINE && reader.size() == COMMAND_READER_SIZE - 1);
+    
+    // === OVERFLOW AND RESYNC ===
+    Serial.println("\n--- Overflow and Resync ---");
+    
+    port.feedRepeated('b', COMMAND_READER_SIZE);
+    port.feed("\n{\"cmd\":5}\n");
+    runTest("Overlong line is reported once", reader.read(port) == READ_LINE_OVERFLOW);
+    runTest("Next line after an overflow is intact",
+            reader.read(port) == READ_LINE && strcmp(reader.line(), "{\"cmd\":5}") == 0);
+    runTest("Nothing else is left", reader.read(port) == READ_PENDING);
+    
+    // Overflow is only reported once the terminator arrives
+    port.feedRepeated('c', COMMAND_READER_SIZE + 20);
+    runTest("Overflowing line waits for its terminator", reader.read(port) == READ_PENDING);
+    port.feed("ccc\n");
+    runTest("Overflow reported at the terminator", reader.read(port) == READ_LINE_OVERFLOW);
+    
+    // === BINARY FRAMES ===
+    Serial.println("\n--- Binary Frames ---");
+    
+    const uint8_t frame[] = {0x00, 0x03, 0x07, 0x11, 0x00};
+    port.feed(frame, sizeof(frame));
+    runTest("Frame is returned without delimiters",
+            reader.read(port) == READ_FRAME && reader.size() == 3 &&
+            reader.frame()[0] == 0x03 && reader.frame()[2] == 0x11);
+    
+    // Repeated delimiters do not make empty frames
+    const uint8_t padded[] = {0x00, 0x00, 0x00, 0x02, 0x05, 0x00};
+    port.feed(padded, sizeof(padded));
+    runTest("Repeated 0x00 just waits for the frame", reader.read(port) == READ_FRAME && reader.size() == 2);
+    
+    // A 0x00 in the middle of a line drops the line and starts a frame
+    port.feed("{\"cmd\":1,");
+    port.feed(frame, sizeof(frame));
+    runTest("Frame start drops a partial line", reader.read(port) == READ_FRAME && reader.size() == 3);
+    
+    // Oversized frame, then a good one
+    const uint8_t delimiter = 0x00;
+    port.feed(&delimiter, 1);
+    port.feedRepeated(0x42, COMMAND_READER_SIZE + 1);
+    port.feed(&delimiter, 1);
+    port.feed(frame, sizeof(frame));
+    runTest("Overlong frame is reported once", reader.read(port) == READ_FRAME_OVERFLOW);
+    runTest("Next frame after an overflow is intact", reader.read(port) == READ_FRAME && reader.size() == 3);
+    
+    // A line right after a frame
+    port.feed("{\"cmd\":7}\n");
+    runTest("Line after a frame is intact",
+            reader.read(port) == READ_LINE && strcmp(reader.line(), "{\"cmd\":7}") == 0);
+    
+    // === SUMMARY ===
+    Serial.println();
+    Serial.print("Total Tests: ");
+    Serial.println(total_tests);
+    Serial.print("Passed: ");
+    Serial.println(passed_tests);
+    Serial.print("Failed: ");
+    Serial.println(total_tests - passed_tests);
+    
+    if (passed_tests == total_tests) {
+        Serial.println("\n🎉 ALL TESTS PASSED!");
+    } else {
+        Serial.println("\n⚠️  SOME TESTS FAILED!");
+    }
+}
+
+void loop() {
+    // Tests run once in setup(), nothing in loop
+    delay(10000);
+}
@@ -0,0 +1,131 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <communication/CommandReader.h>
+#include <communication/JsonArena.h>
+
+// Test counter and results
+int total_tests = 0;
+int passed_tests = 0;
+
+void runTest(const char* test_name, bool condition) {
+    total_tests++;
+    Serial.print("Test: ");
+    Serial.print(test_name);
+    Serial.print(" ... ");
+    if (condition) {
+        passed_tests++;
+        Serial.println("✓ PASS");
+    } else {
+        Serial.println("✗ FAIL");
+    }
+}
+
+// Separate from the firmware's arena, so the peak is this test's alone
+JsonArena arena;
+
+// CURVE_TO has the most members of any command; every value at full width
+const char LARGEST_COMMAND[] =
+    "{\"cmd\":13,\"c1x\":-99.9375,\"c1y\":-99.9375,\"c2x\":-99.9375,"
+    "\"c2y\":-99.9375,\"x\":-99.9375,\"y\":-99.9375,\"speed\":99.9375}";
+
+// Longest reply sent while a command document is still alive (sendError)
+const char* LONGEST_ERROR = "CURVE_TO requires c1x,c1y,c2x,c2y,x,y coordinates";
+
+void setup() {
+    Serial.begin(9600);
+    delay(2000);
+    
+    Serial.println("=== TerraPen Motion Control - JSON Arena Tests ===");
+    Serial.println("Sizes JSON_ARENA_SIZE: the largest command and its reply");
+    Serial.println("must fit together, as they do inside processCommand().");
+    
+    // === LARGEST COMMAND ===
+    Serial.println("\n--- Largest Command and Reply ---");
+    
+    runTest("Largest command fits the command reader", strlen(LARGEST_COMMAND) < COMMAND_READER_SIZE);
+    
+    {
+        // Parsed in place from a mutable copy, as from the reader's buffer
+        char line[COMMAND_READER_SIZE];
+        strcpy(line, LARGEST_COMMAND);
+        JsonDocument command(&arena);
+        DeserializationError error = deserializeJson(command, line, strlen(line));
+        runTest("CURVE_TO parses inside the arena", !error);
+        runTest("CURVE_TO values read back",
+                command["cmd"].as<int>() == 13 && command["c1x"].as<float>() == -99.9375 &&
+                command["y"].as<float>() == -99.9375 && command["speed"].as<float>() == 99.9375);
+        
+        // The handler answers before the command document goes away
+        JsonDocument reply(&arena);
+        reply["response"] = 129;
+        reply["error_message"] = LONGEST_ERROR;  // const char*, so copied like in sendError()
+        reply["timestamp"] = 4294967295UL;
+        char output[128];
+        size_t written = serializeJson(reply, output, sizeof(output));
+        runTest("Reply builds beside the command", !reply.overflowed() && written > 0);
+    }
+    
+    size_t peak = arena.getPeakUsage();
+    Serial.print("  Peak arena use (bytes): ");
+    Serial.print(peak);
+    Serial.print(" of ");
+    Serial.println(JSON_ARENA_SIZE);
+    runTest("Peak use leaves a 64-byte margin", peak + 64 <= JSON_ARENA_SIZE);
+    
+    // === REUSE ===
+    Serial.println("\n--- Reuse ---");
+    
+    {
+        char line[COMMAND_READER_SIZE];
+        strcpy(line, LARGEST_COMMAND);
+        JsonDocument command(&arena);
+        runTest("Arena starts over once every document is freed", !deserializeJson(command, line, strlen(line)));
+    }
+    runTest("Repeating a command does not raise the peak", arena.getPeakUsage() == peak);
+    
+    // === OVERFLOW ===
+    Serial.println("\n--- Overflow ---");
+    
+    {
+        // Far more members than the arena holds
+        char huge[2 * 120 + 2];
+        uint8_t length = 0;
+        huge[length++] = '[';
+        for (uint8_t i = 0; i < 120; i++) {
+            huge[length++] = '1';
+            huge[length++] = (i < 119) ? ',' : ']';
+        }
+        huge[length] = '\0';
+        
+        JsonDocument big(&arena);
+        runTest("Oversized document reports NoMemory",
+                deserializeJson(big, huge, length) == DeserializationError::NoMemory);
+    }
+    
+    {
+        char line[COMMAND_READER_SIZE];
+        strcpy(line, LARGEST_COMMAND);
+        JsonDocument command(&arena);
+        runTest("Arena recovers after NoMemory", !deserializeJson(command, line, strlen(line)));
+    }
+    
+    // === SUMMARY ===
+    Serial.println();
+    Serial.print("Total Tests: ");
+    Serial.println(total_tests);
+    Serial.print("Passed: ");
+    Serial.println(passed_tests);
+    Serial.print("Failed: ");
+    Serial.println(total_tests - passed_tests);
+    
+    if (passed_tests == total_tests) {
+        Serial.println("\n🎉 ALL TESTS PASSED!");
+    } else {
+        Serial.println("\n⚠️  SOME TESTS FAILED!");
+    }
+}
+
+void loop() {
+    // Tests run once in setup(), nothing in loop
+    delay(10000);
+}
@@ -1,6 +1,7 @@
 #include <Arduino.h>
 #include <Position.h>
 #include <TerraPenConfig.h>
+#include <robot/KinematicModel.h>
 
 // Test counter and results
 int total_tests = 0;
@@ -153,6 +154,136 @@ void setup() {
     float full_rotation_steps = full_arc * steps_per_mm;
     runTest("360° rotation steps", full_rotation_steps > 4 * rotation_steps);
     
+    // === FIXED-POINT KINEMATICS ===
+    Serial.println("\n--- Fixed-Point Kinematics vs Float ---");
+    
+    KinematicModel kinematics;
+    kinematics.configure(WHEEL_DIAMETER, WHEEL_DIAMETER, WHEELBASE, (uint16_t)STEPS_PER_REV);
+    
+    runTest("Steps per mm constant", abs(fixedToFloat(kinematics.getLeftWheel().steps_per_mm) - steps_per_mm) < 0.0001);
+    runTest("Steps per radian constant",
+            abs(fixedToFloat(kinematics.getLeftWheel().steps_per_radian) - steps_per_mm * WHEELBASE / 2.0) < 0.001);
+    
+    // Sweep the workspace: forward kinematics must round to the same step as float
+    int step_mismatches = 0;
+    float max_distance_error = 0.0;
+    float max_angle_error = 0.0;
+    for (int d = -200; d <= 200; d += 7) {
+        for (int a = -63; a <= 63; a += 5) {
+            float distance = d * 1.013;       // Off-grid values, not step multiples
+            float angle = a * 0.1;
+            
+            float float_arc = angle * WHEELBASE / 2.0;
+            int float_left = (int)round((distance - float_arc) * steps_per_mm);
+            int float_right = (int)round((distance + float_arc) * steps_per_mm);
+            
+            int fixed_left, fixed_right;
+            kinematics.toSteps(floatToFixed(distance), floatToFixed(angle), fixed_left, fixed_right);
+            if (abs(fixed_left - float_left) > 1 || abs(fixed_right - float_right) > 1) {
+                step_mismatches++;
+            }
+            
+            // Inverse kinematics on the same steps
+            fixed_t fixed_distance, fixed_angle;
+            kinematics.toMovement(fixed_left, fixed_right, fixed_distance, fixed_angle);
+            float left_mm = fixed_left / steps_per_mm;
+            float right_mm = fixed_right / steps_per_mm;
+            max_distance_error = max(max_distance_error, (float)abs(fixedToFloat(fixed_distance) - (left_mm + right_mm) / 2.0));
+            max_angle_error = max(max_angle_error, (float)abs(fixedToFloat(fixed_angle) - (right_mm - left_mm) / WHEELBASE));
+        }
+    }
+    runTest("Fixed-point steps within 1 of float", step_mismatches == 0);
+    runTest("Fixed-point distance within 0.001mm", max_distance_error < 0.001);
+    runTest("Fixed-point angle within 0.0001 rad", max_angle_error < 0.0001);
+    Serial.print("  Max distance error (mm): ");
+    Serial.println(max_distance_error, 6);
+    Serial.print("  Max angle error (rad): ");
+    Serial.println(max_angle_error, 6);
+    
+    // Round trip through steps stays within half a step
+    int rt_left, rt_right;
+    fixed_t rt_distance, rt_angle;
+    kinematics.toSteps(floatToFixed(-37.25), floatToFixed(1.2), rt_left, rt_right);
+    kinematics.toMovement(rt_left, rt_right, rt_distance, rt_angle);
+    runTest("Fixed-point round trip distance", abs(fixedToFloat(rt_distance) + 37.25) < 0.5 / steps_per_mm);
+    runTest("Fixed-point round trip angle", abs(fixedToFloat(rt_angle) - 1.2) < 1.0 / (steps_per_mm * WHEELBASE));
+    
+    // Calibrated wheels of different sizes
+    Serial.println("\n--- Per-Wheel Calibration ---");
+    
+    const float LEFT_DIAMETER = 24.6;   // mm, a few percent apart like real 28BYJ builds
+    const float RIGHT_DIAMETER = 25.4;
+    KinematicModel calibrated;
+    calibrated.configure(LEFT_DIAMETER, RIGHT_DIAMETER, WHEELBASE, (uint16_t)STEPS_PER_REV);
+    
+    int cal_left, cal_right;
+    calibrated.toSteps(floatToFixed(100.0), 0, cal_left, cal_right);
+    runTest("Smaller wheel takes more steps", cal_left > cal_right);
+    runTest("Left wheel steps match its diameter",
+            cal_left == (int)round(100.0 * STEPS_PER_REV / (PI * LEFT_DIAMETER)));
+    runTest("Right wheel steps match its diameter",
+            cal_right == (int)round(100.0 * STEPS_PER_REV / (PI * RIGHT_DIAMETER)));
+    
+    // Unequal step counts for a straight line must not register as a turn
+    float cal_distance, cal_angle;
+    calibrated.toMovement(cal_left, cal_right, cal_distance, cal_angle);
+    runTest("Calibrated straight line distance", abs(cal_distance - 100.0) < 0.05);
+    runTest("Calibrated straight line has no turn", abs(cal_angle) < 0.005);
+    
+    // Spin in place: each wheel covers the same arc with its own step count
+    calibrated.toSteps(0, floatToFixed(PI), cal_left, cal_right);
+    calibrated.toMovement(cal_left, cal_right, cal_distance, cal_angle);
+    runTest("Calibrated spin has no drift", abs(cal_distance) < 0.05);
+    runTest("Calibrated spin angle", abs(cal_angle - PI) < 0.005);
+    
+    // Carried remainders: many small turns issue the rounded total, not the sum of rounded turns
+    StepRemainder remainder = {0, 0};
+    long chained_left = 0, chained_right = 0;
+    int single_left, single_right;
+    for (int i = 0; i < 300; i++) {
+        kinematics.toSteps(0, floatToFixed(0.013), single_left, single_right, remainder);
+        chained_left += single_left;
+        chained_right += single_right;
+    }
+    kinematics.toSteps(0, floatToFixed(300 * 0.013), single_left, single_right);
+    runTest("Chained turns total within a step", abs(chained_left - single_left) <= 1 && abs(chained_right - single_right) <= 1);
+    kinematics.toSteps(0, floatToFixed(0.013), single_left, single_right);
+    runTest("Per-turn rounding alone would drift", abs(300L * single_right - chained_right) > 10);
+    
+    // Past the 16-bit step range conversions are refused instead of wrapping
+    int far_left = 1, far_right = 1;
+    runTest("Out-of-range move is rejected",
+            !kinematics.toSteps(floatToFixed(2000.0), 0, far_left, far_right) && far_left == 0 && far_right == 0);
+    runTest("Long move within range converts",
+            kinematics.toSteps(floatToFixed(600.0), 0, far_left, far_right) && far_left == (int)round(600.0 * steps_per_mm));
+    
+    // === BINARY ANGLES ===
+    Serial.println("\n--- Binary Angle Headings ---");
+    
+    bam_t quarter = radiansToBam(PI / 2);
+    runTest("Quarter turn is 2^30", bamMagnitude(quarter - BAM_QUARTER_TURN) < 4);
+    runTest("Half turn wraps to -PI", abs(bamToRadians(quarter + BAM_HALF_TURN) + PI / 2) < 0.0001);
+    runTest("Difference is the shortest turn",
+            abs(bamToRadians(radiansToBam(-3.0) - radiansToBam(3.0)) - (2 * PI - 6.0)) < 0.0001);
+    runTest("Multi-turn radians wrap", abs(bamToRadians(radiansToBam(4 * PI + PI / 4)) - PI / 4) < 0.0001);
+    runTest("wrapRadians negative multi-wrap", abs(wrapRadians(-5 * PI - PI / 4) - 3 * PI / 4) < 0.0001);
+    
+    // Headings summed from steps: a full spin lands back on zero
+    int spin_left, spin_right;
+    kinematics.toSteps(0, floatToFixed(PI / 4), spin_left, spin_right);
+    bam_t spin = 0;
+    for (int i = 0; i < 8; i++) {
+        spin += kinematics.toHeadingChange(spin_left, spin_right);
+    }
+    float spin_float, spin_distance;
+    kinematics.toMovement(8 * spin_left, 8 * spin_right, spin_distance, spin_float);
+    runTest("Step heading matches float heading", abs(bamToRadians(spin) - wrapRadians(spin_float)) < 0.0001);
+    
+    // Odometry totals outgrow 16 bits; the heading still wraps exactly
+    float long_turn = 200000.0 / steps_per_mm / WHEELBASE;
+    runTest("Long step counts give the wrapped heading",
+            abs(bamToRadians(kinematics.toHeadingChange(-100000L, 100000L)) - wrapRadians(long_turn)) < 0.001);
+    
     // === COORDINATE-TO-MOVEMENT CONVERSION ===
     Serial.println("\n--- Coordinate to Movement Conversion ---");
     
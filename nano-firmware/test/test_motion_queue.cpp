@@ -0,0 +1,123 @@
+#include <Arduino.h>
+#include <robot/MotionQueue.h>
+
+// Test counter and results
+int total_tests = 0;
+int passed_tests = 0;
+
+void runTest(const char* test_name, bool condition) {
+    total_tests++;
+    Serial.print("Test: ");
+    Serial.print(test_name);
+    Serial.print(" ... ");
+    if (condition) {
+        passed_tests++;
+        Serial.println("✓ PASS");
+    } else {
+        Serial.println("✗ FAIL");
+    }
+}
+
+/**
+ * Segment tagged with a sequence number so order can be checked
+ */
+MotionSegment makeSegment(int sequence) {
+    MotionSegment segment = {SEGMENT_DRAW, false, (float)sequence, 0.0, 10.0};
+    return segment;
+}
+
+void setup() {
+    Serial.begin(9600);
+    delay(2000);
+    
+    Serial.println("=== TerraPen Motion Control - Motion Queue Tests ===");
+    
+    // === EMPTY QUEUE ===
+    Serial.println("\n--- Empty Queue ---");
+    
+    MotionQueue queue;
+    MotionSegment segment;
+    runTest("New queue is empty", queue.isEmpty() && !queue.isFull() && queue.count() == 0);
+    runTest("New queue has every slot free", queue.getFreeSlots() == MOTION_QUEUE_SIZE);
+    runTest("Pop on empty queue fails", !queue.pop(segment));
+    runTest("Peek on empty queue returns nullptr", queue.peek() == nullptr);
+    
+    // === FULL QUEUE ===
+    Serial.println("\n--- Full Queue ---");
+    
+    bool pushed_all = true;
+    for (int i = 0; i < MOTION_QUEUE_SIZE; i++) {
+        pushed_all = pushed_all && queue.push(makeSegment(i));
+    }
+    runTest("Queue accepts MOTION_QUEUE_SIZE segments", pushed_all);
+    runTest("Queue reports full", queue.isFull() && !queue.isEmpty());
+    runTest("Full queue has no free slots", queue.getFreeSlots() == 0 && queue.count() == MOTION_QUEUE_SIZE);
+    runTest("Push on full queue fails", !queue.push(makeSegment(99)));
+    runTest("Rejected push leaves the count unchanged", queue.count() == MOTION_QUEUE_SIZE);
+    runTest("Peek returns the oldest segment", queue.peek() != nullptr && queue.peek()->x == 0.0);
+    
+    bool in_order = true;
+    for (int i = 0; i < MOTION_QUEUE_SIZE; i++) {
+        in_order = in_order && queue.pop(segment) && segment.x == (float)i;
+    }
+    runTest("Segments come out in push order", in_order);
+    runTest("Drained queue is empty", queue.isEmpty() && !queue.pop(segment));
+    
+    // === CLEAR ===
+    Serial.println("\n--- Clear ---");
+    
+    queue.push(makeSegment(1));
+    queue.push(makeSegment(2));
+    queue.clear();
+    runTest("Clear empties the queue", queue.isEmpty() && queue.getFreeSlots() == MOTION_QUEUE_SIZE);
+    
+    // === WRAPAROUND ===
+    Serial.println("\n--- Wraparound ---");
+    
+    // Indices are free-running uint8_t, so 300 segments cross both the
+    // slot wrap (every MOTION_QUEUE_SIZE) and the index wrap at 256
+    bool fifo = true;
+    bool counted = true;
+    int next_in = 0;
+    int next_out = 0;
+    while (next_out < 300) {
+        // Keep the queue between half and completely full
+        while (!queue.isFull()) {
+            queue.push(makeSegment(next_in++));
+        }
+        counted = counted && (queue.count() == MOTION_QUEUE_SIZE) && !queue.push(makeSegment(-1));
+        for (int i = 0; i < MOTION_QUEUE_SIZE / 2; i++) {
+            fifo = fifo && queue.pop(segment) && segment.x == (float)next_out;
+            next_out++;
+        }
+        counted = counted && (queue.count() == MOTION_QUEUE_SIZE / 2);
+    }
+    runTest("FIFO order holds across index wraparound", fifo);
+    runTest("Full/count stay correct across wraparound", counted);
+    
+    while (queue.pop(segment)) {
+        fifo = fifo && segment.x == (float)next_out;
+        next_out++;
+    }
+    runTest("Queue drains to empty after wraparound", queue.isEmpty() && next_out == next_in && fifo);
+    
+    // === SUMMARY ===
+    Serial.println();
+    Serial.print("Total Tests: ");
+    Serial.println(total_tests);
+    Serial.print("Passed: ");
+    Serial.println(passed_tests);
+    Serial.print("Failed: ");
+    Serial.println(total_tests - passed_tests);
+    
+    if (passed_tests == total_tests) {
+        Serial.println("\n🎉 ALL TESTS PASSED!");
+    } else {
+        Serial.println("\n⚠️  SOME TESTS FAILED!");
+    }
+}
+
+void loop() {
+    // Tests run once in setup(), nothing in loop
+    delay(10000);
+}
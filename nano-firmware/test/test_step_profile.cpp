@@ -0,0 +1,215 @@
+#include <Arduino.h>
+#include <TerraPenConfig.h>
+#include <hardware/StepEngine.h>
+#include <hardware/StepperDriver.h>
+
+// Test counter and results
+int total_tests = 0;
+int passed_tests = 0;
+
+void runTest(const char* test_name, bool condition) {
+    total_tests++;
+    Serial.print("Test: ");
+    Serial.print(test_name);
+    Serial.print(" ... ");
+    if (condition) {
+        passed_tests++;
+        Serial.println("✓ PASS");
+    } else {
+        Serial.println("✗ FAIL");
+    }
+}
+
+/**
+ * Peak rates of one block, in steps/s, steps/s^2 and steps/s^3
+ */
+struct ProfileStats {
+    float peak_speed;
+    float peak_accel;
+    float peak_jerk;
+    unsigned long steps;
+};
+
+StepperDriver left_motor;
+StepperDriver right_motor;
+StepEngine engine;
+
+/**
+ * Run one block by hand and measure the intervals the engine schedules,
+ * so the result does not depend on the tick resolution. Intervals are
+ * averaged over groups of steps: single intervals are whole microseconds,
+ * and near full speed that rounding alone reads as a large jerk.
+ */
+ProfileStats runBlock(long steps, uint16_t interval_us, MotionProfile profile) {
+    const uint8_t GROUP_STEPS = 4;
+    ProfileStats stats = {0.0, 0.0, 0.0, 0};
+    engine.queueBlock(steps, steps / 2, interval_us, profile);
+    
+    long position = engine.getLeftPosition();
+    engine.onTick();  // Loads the block
+    uint16_t interval = engine.getStepInterval();
+    unsigned long group_us = 0;
+    unsigned long groups = 0;
+    float last_group_us = 0.0;
+    float last_speed = 0.0;
+    float last_accel = 0.0;
+    
+    while (interval > 0) {
+        float speed = 1000000.0 / interval;
+        if (speed > stats.peak_speed) stats.peak_speed = speed;
+        stats.steps++;
+        group_us += interval;
+        
+        if (stats.steps % GROUP_STEPS == 0) {
+            // Differences need one (acceleration) or two (jerk) earlier groups
+            float group_speed = GROUP_STEPS * 1000000.0 / group_us;
+            if (groups > 0) {
+                float dt = (group_us + last_group_us) / 2000000.0;
+                float accel = (group_speed - last_speed) / dt;
+                if (fabs(accel) > stats.peak_accel) stats.peak_accel = fabs(accel);
+                if (groups > 1) {
+                    float jerk = (accel - last_accel) / dt;
+                    if (fabs(jerk) > stats.peak_jerk) stats.peak_jerk = fabs(jerk);
+                }
+                last_accel = accel;
+            }
+            last_group_us = group_us;
+            last_speed = group_speed;
+            group_us = 0;
+            groups++;
+        }
+        
+        // Tick until the left (major) wheel takes its next step
+        while (engine.getLeftPosition() == position && !engine.isIdle()) {
+            engine.onTick();
+        }
+        position = engine.getLeftPosition();
+        interval = engine.getStepInterval();
+    }
+    return stats;
+}
+
+void compareProfiles(const char* label, uint16_t ramp_steps, long steps, bool cruises) {
+    Serial.print("\n--- ");
+    Serial.print(label);
+    Serial.println(" ---");
+    
+    engine.configureRamp(10000, 600, ramp_steps);
+    ProfileStats trapezoid = runBlock(steps, 600, PROFILE_TRAPEZOID);
+    ProfileStats scurve = runBlock(steps, 600, PROFILE_SCURVE);
+    
+    Serial.print("Trapezoid accel/jerk: ");
+    Serial.print(trapezoid.peak_accel, 0);
+    Serial.print(" / ");
+    Serial.println(trapezoid.peak_jerk, 0);
+    Serial.print("S-curve accel/jerk:   ");
+    Serial.print(scurve.peak_accel, 0);
+    Serial.print(" / ");
+    Serial.println(scurve.peak_jerk, 0);
+    
+    runTest("Both profiles issue every step", trapezoid.steps == (unsigned long)steps && scurve.steps == (unsigned long)steps);
+    if (cruises) {
+        runTest("S-curve reaches the trapezoid's top speed", scurve.peak_speed > trapezoid.peak_speed * 0.95);
+    }
+    
+    // The smoothstep peak is planned at the trapezoid acceleration;
+    // interpolating between knots may overshoot it only slightly
+    runTest("S-curve peak acceleration within 10% of trapezoid", scurve.peak_accel < trapezoid.peak_accel * 1.10);
+    runTest("S-curve peak jerk under 1/4 of trapezoid", scurve.peak_jerk < trapezoid.peak_jerk * 0.25);
+}
+
+void testKnotTable() {
+    Serial.println("\n--- Shared S-curve Knot Table ---");
+    
+    engine.configureRamp(10000, 600, 50);
+    runTest("First S-curve block is queued", engine.queueBlock(400, 200, 600, PROFILE_SCURVE));
+    runTest("Trapezoid block queues behind it", engine.queueBlock(100, 100, 600, PROFILE_TRAPEZOID));
+    runTest("Second S-curve block waits for the knot table", !engine.queueBlock(400, 200, 600, PROFILE_SCURVE));
+    
+    while (!engine.isIdle()) engine.onTick();
+    runTest("Knot table is free once the block has run", engine.queueBlock(400, 200, 600, PROFILE_SCURVE));
+    while (!engine.isIdle()) engine.onTick();
+}
+
+/**
+ * Tick the idle engine and count the ticks with the left coil energised
+ */
+unsigned int countHeldTicks(unsigned int ticks) {
+    unsigned int held = 0;
+    for (unsigned int i = 0; i < ticks; i++) {
+        engine.onTick();
+        if (left_motor.isHolding()) held++;
+    }
+    return held;
+}
+
+void testIdleHold() {
+    Serial.println("\n--- Idle Hold ---");
+    
+    engine.setIdleHold(30);
+    unsigned int held = countHeldTicks(1000);
+    Serial.print("Coil on for ticks at 30%: ");
+    Serial.println(held);
+    runTest("Reduced hold energises the coils for its share of ticks", held >= 290 && held <= 310);
+    
+    // A new duty that lands on an off tick still applies
+    while (left_motor.isHolding()) engine.onTick();
+    engine.setIdleHold(50);
+    held = countHeldTicks(1000);
+    runTest("Hold set on an off tick applies its duty", held >= 490 && held <= 510);
+    
+    // Emergency stop while chopping: nothing turns the coils back on
+    engine.release();
+    runTest("Release during a chop leaves the coils released", countHeldTicks(1000) == 0);
+    engine.setIdleHold(30);
+    runTest("Reduced hold after a release keeps the coils released", countHeldTicks(1000) == 0);
+}
+
+void setup() {
+    Serial.begin(9600);
+    delay(2000);
+    
+    Serial.println("=== TerraPen Motion Control - Step Profile Tests ===");
+    Serial.println("Compares S-curve and trapezoid ramps from the intervals");
+    Serial.println("the step engine schedules.");
+    
+    left_motor.begin(g_config.hardware.motor_l_pins[0], g_config.hardware.motor_l_pins[1],
+                     g_config.hardware.motor_l_pins[2], g_config.hardware.motor_l_pins[3]);
+    right_motor.begin(g_config.hardware.motor_r_pins[0], g_config.hardware.motor_r_pins[1],
+                      g_config.hardware.motor_r_pins[2], g_config.hardware.motor_r_pins[3]);
+    engine.begin(&left_motor, &right_motor);
+
+#if defined(__AVR__)
+    // The tests tick the engine themselves
+    TIMSK2 &= ~_BV(OCIE2A);
+#endif
+
+    compareProfiles("Default ramp (50 steps), long block", 50, 400, true);
+    compareProfiles("Long ramp (200 steps), long block", 200, 1000, true);
+    compareProfiles("Default ramp, block too short to cruise", 50, 60, false);
+    testKnotTable();
+    testIdleHold();
+    
+    // === SUMMARY ===
+    Serial.println();
+    Serial.print("Total Tests: ");
+    Serial.println(total_tests);
+    Serial.print("Passed: ");
+    Serial.println(passed_tests);
+    Serial.print("Failed: ");
+    Serial.println(total_tests - passed_tests);
+    
+    if (passed_tests == total_tests) {
+        Serial.println("\n🎉 ALL TESTS PASSED!");
+    } else {
+        Serial.println("\n⚠️  SOME TESTS FAILED!");
+    }
+    
+    left_motor.release();
+    right_motor.release();
+}
+
+void loop() {
+    // Tests run once in setup(), nothing in loop
+    delay(10000);
+}
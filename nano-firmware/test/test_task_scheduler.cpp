@@ -0,0 +1,183 @@
+#include <Arduino.h>
+#include <TaskScheduler.h>
+
+// Test counter and results
+int total_tests = 0;
+int passed_tests = 0;
+
+void runTest(const char* test_name, bool condition) {
+    total_tests++;
+    Serial.print("Test: ");
+    Serial.print(test_name);
+    Serial.print(" ... ");
+    if (condition) {
+        passed_tests++;
+        Serial.println("✓ PASS");
+    } else {
+        Serial.println("✗ FAIL");
+    }
+}
+
+// Tasks record how often and in which order they ran, and busy-wait to
+// stand in for real work
+int fast_runs = 0;
+int slow_runs = 0;
+char run_order[8];
+uint8_t run_order_length = 0;
+unsigned int busy_us = 0;
+
+void recordRun(char name) {
+    if (run_order_length < sizeof(run_order) - 1) {
+        run_order[run_order_length++] = name;
+        run_order[run_order_length] = '\0';
+    }
+}
+
+void fastTask() {
+    fast_runs++;
+    recordRun('F');
+}
+
+void slowTask() {
+    slow_runs++;
+    recordRun('S');
+}
+
+void busyTask() {
+    recordRun('B');
+    delayMicroseconds(busy_us);
+}
+
+void quickTask() {
+    recordRun('Q');
+    delayMicroseconds(200);
+}
+
+/**
+ * Call run() back to back for a while, as loop() does
+ */
+void runFor(TaskScheduler& scheduler, unsigned long duration_us) {
+    unsigned long start_us = micros();
+    while (micros() - start_us < duration_us) {
+        scheduler.run();
+        delayMicroseconds(100);
+    }
+}
+
+void setup() {
+    Serial.begin(9600);
+    delay(2000);
+    
+    Serial.println("=== TerraPen Motion Control - Task Scheduler Tests ===");
+    
+    // === REGISTRATION ===
+    Serial.println("\n--- Registration ---");
+    
+    TaskScheduler table;
+    runTest("Null task is refused", table.addTask(nullptr, 1000, 0, TASK_PRIORITY_MOTION) == -1);
+    bool registered = true;
+    for (int i = 0; i < TASK_SCHEDULER_MAX_TASKS; i++) {
+        registered = registered && table.addTask(fastTask, 1000, 0, TASK_PRIORITY_BACKGROUND) == i;
+    }
+    runTest("Ids follow registration order", registered);
+    runTest("Full table refuses another task", table.addTask(fastTask, 1000, 0, TASK_PRIORITY_MOTION) == -1);
+    runTest("Task count matches", table.getTaskCount() == TASK_SCHEDULER_MAX_TASKS);
+    
+    // === PERIODS ===
+    Serial.println("\n--- Periods ---");
+    
+    TaskScheduler periods;
+    periods.addTask(fastTask, 2000, 0, TASK_PRIORITY_MOTION);
+    periods.addTask(slowTask, 10000, 0, TASK_PRIORITY_TELEMETRY);
+    runTest("Nothing runs before the first release", !periods.run() && fast_runs == 0);
+    
+    fast_runs = 0;
+    slow_runs = 0;
+    runFor(periods, 100000);
+    Serial.print("  Runs in 100 ms (2 ms / 10 ms periods): ");
+    Serial.print(fast_runs);
+    Serial.print(" / ");
+    Serial.println(slow_runs);
+    runTest("2 ms task runs about 50 times in 100 ms", fast_runs >= 48 && fast_runs <= 50);
+    runTest("10 ms task runs about 10 times in 100 ms", slow_runs >= 9 && slow_runs <= 10);
+    
+    // A stalled loop skips missed releases rather than catching up back to back
+    fast_runs = 0;
+    delay(20);
+    periods.run();
+    periods.run();
+    runTest("Missed releases are skipped, not replayed", fast_runs == 1);
+    
+    // === PRIORITY ===
+    Serial.println("\n--- Priority Order ---");
+    
+    TaskScheduler order;
+    order.addTask(slowTask, 1000, 0, TASK_PRIORITY_BACKGROUND);
+    order.addTask(fastTask, 1000, 0, TASK_PRIORITY_MOTION);
+    order.addTask(quickTask, 1000, 0, TASK_PRIORITY_BACKGROUND);
+    delay(2);
+    run_order_length = 0;
+    order.run();
+    Serial.print("  Pass order: ");
+    Serial.println(run_order);
+    runTest("Higher priority runs first, equal priority in registration order",
+            run_order_length == 3 && run_order[0] == 'F' && run_order[1] == 'S' && run_order[2] == 'Q');
+    
+    // === DEADLINES ===
+    Serial.println("\n--- Deadlines and Lateness ---");
+    
+    TaskScheduler deadlines;
+    int8_t busy = deadlines.addTask(busyTask, 5000, 2000, TASK_PRIORITY_MOTION);
+    int8_t quick = deadlines.addTask(quickTask, 5000, 2000, TASK_PRIORITY_BACKGROUND);
+    
+    // Short runs right at release meet their deadlines
+    busy_us = 500;
+    delay(5);
+    deadlines.run();
+    runTest("Runs inside the deadline are not overruns",
+            deadlines.getOverruns(busy) == 0 && deadlines.getOverruns(quick) == 0);
+    runTest("Longest run time is recorded", deadlines.getMaxRunTime(busy) >= 500);
+    
+    // The loop slept well past the release: that wait is not lateness
+    delay(12);
+    deadlines.run();
+    runTest("Time asleep before the pass is not counted",
+            deadlines.getOverruns(busy) == 0 && deadlines.getOverruns(quick) == 0);
+    
+    // A run longer than the deadline is an overrun
+    busy_us = 3000;
+    delay(5);
+    deadlines.run();
+    runTest("Run longer than its deadline is an overrun", deadlines.getOverruns(busy) == 1);
+    
+    // Waiting behind a higher-priority task in the same pass does count
+    runTest("Waiting behind a higher-priority task counts", deadlines.getOverruns(quick) == 1);
+    
+    // Deadline 0 is never checked
+    TaskScheduler unchecked;
+    int8_t free_running = unchecked.addTask(busyTask, 1000, 0, TASK_PRIORITY_MOTION);
+    delay(2);
+    unchecked.run();
+    runTest("Deadline 0 is not checked", unchecked.getOverruns(free_running) == 0);
+    runTest("Unknown id reports nothing", unchecked.getOverruns(5) == 0 && unchecked.getMaxRunTime(5) == 0);
+    
+    // === SUMMARY ===
+    Serial.println();
+    Serial.print("Total Tests: ");
+    Serial.println(total_tests);
+    Serial.print("Passed: ");
+    Serial.println(passed_tests);
+    Serial.print("Failed: ");
+    Serial.println(total_tests - passed_tests);
+    
+    if (passed_tests == total_tests) {
+        Serial.println("\n🎉 ALL TESTS PASSED!");
+    } else {
+        Serial.println("\n⚠️  SOME TESTS FAILED!");
+    }
+}
+
+void loop() {
+    // Tests run once in setup(), nothing in loop
+    delay(10000);
+}